@@ -0,0 +1,233 @@
+#include "BatchRunner.h"
+#include "CommandLine.h"
+#include "EnsembleSimulation.h"
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <tuple>
+#include <chrono>
+#include <omp.h>
+
+std::vector<BatchScenario> readBatchFile(const std::string& filename,
+                                         const SimulationConfig& base) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open batch file " + filename);
+    }
+
+    std::vector<BatchScenario> scenarios;
+    std::string line;
+    int line_number = 0;
+
+    while (std::getline(file, line)) {
+        ++line_number;
+        std::vector<std::string> tokens = tokenize(line);
+        if (tokens.empty() || tokens[0][0] == '#') {
+            continue;
+        }
+
+        const std::string where = filename + ":" + std::to_string(line_number) + ": ";
+
+        BatchScenario scenario;
+        scenario.name = tokens[0];
+        scenario.config = base;
+        scenario.config.output_dir.clear();
+
+        for (size_t i = 1; i < tokens.size(); ++i) {
+            bool known = false;
+            try {
+                known = applyConfigOption(tokens, i, scenario.config);
+            } catch (const std::exception& e) {
+                throw std::runtime_error(where + e.what());
+            }
+            if (!known) {
+                throw std::runtime_error(where + "unknown option '" + tokens[i] + "'");
+            }
+        }
+
+        if (scenario.config.output_dir.empty()) {
+            scenario.config.output_dir = base.output_dir + "/" + scenario.name;
+        }
+        scenarios.push_back(scenario);
+    }
+
+    return scenarios;
+}
+
+void prepareOutputDirectories(const SimulationConfig& config) {
+    std::filesystem::create_directories(config.output_dir);
+    if (config.save_video_frames) {
+        std::filesystem::create_directories(config.output_dir + "/video_frames");
+    }
+}
+
+std::vector<BatchResult> runBatch(const std::vector<BatchScenario>& scenarios, int jobs) {
+    const int n = static_cast<int>(scenarios.size());
+    jobs = std::max(1, std::min(jobs, n));
+    const int threads_per_job = std::max(1, omp_get_max_threads() / jobs);
+
+    // Build each distinct grid once; simulations only read it
+    std::map<std::tuple<int, int, double, double>, std::shared_ptr<const SimulationGrid>> grids;
+    for (const auto& s : scenarios) {
+        auto key = std::make_tuple(s.config.nx, s.config.ny, s.config.Lx, s.config.Ly);
+        if (grids.find(key) == grids.end()) {
+            grids[key] = makeGrid(s.config);
+        }
+    }
+
+    std::cout << "Batch: " << n << " scenarios, " << jobs << " at a time, "
+              << threads_per_job << " OpenMP threads each" << std::endl;
+
+    std::vector<BatchResult> results(n);
+    std::atomic<int> next{0};
+    std::mutex print_mutex;
+
+    auto worker = [&]() {
+        // OpenMP settings are per thread, so each scenario team gets its share
+        omp_set_num_threads(threads_per_job);
+
+        for (int k = next++; k < n; k = next++) {
+            const BatchScenario& scenario = scenarios[k];
+            BatchResult& result = results[k];
+            result.name = scenario.name;
+            result.output_dir = scenario.config.output_dir;
+
+            {
+                std::lock_guard<std::mutex> lock(print_mutex);
+                std::cout << "[" << k + 1 << "/" << n << "] " << scenario.name
+                          << " -> " << scenario.config.output_dir << std::endl;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            try {
+                prepareOutputDirectories(scenario.config);
+                std::ofstream log(scenario.config.output_dir + "/simulation_log.txt");
+
+                const auto& c = scenario.config;
+                auto grid = grids.at(std::make_tuple(c.nx, c.ny, c.Lx, c.Ly));
+
+                WeldingSimulation sim(scenario.config, grid, &log);
+                sim.run();
+                sim.exportResults();
+
+                result.stats = sim.statistics();
+                result.ok = true;
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            result.seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(print_mutex);
+            if (result.ok) {
+                std::cout << "[" << k + 1 << "/" << n << "] " << scenario.name
+                          << " done in " << result.seconds << "s" << std::endl;
+            } else {
+                std::cerr << "Error: scenario " << scenario.name << ": " << result.error << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < jobs; ++w) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    return results;
+}
+
+std::vector<BatchResult> runEnsembleBatch(const std::vector<BatchScenario>& scenarios) {
+    const int n = static_cast<int>(scenarios.size());
+
+    // Group scenarios that can share a sweep, keeping file order within groups
+    std::vector<std::vector<int>> groups;
+    for (int k = 0; k < n; ++k) {
+        bool placed = false;
+        for (auto& g : groups) {
+            if (EnsembleSimulation::compatible(scenarios[g[0]].config, scenarios[k].config)) {
+                g.push_back(k);
+                placed = true;
+                break;
+            }
+        }
+        if (!placed) {
+            groups.push_back({k});
+        }
+    }
+
+    std::cout << "Batch: " << n << " scenarios in " << groups.size()
+              << " ensemble(s)" << std::endl;
+
+    std::vector<BatchResult> results(n);
+    for (const auto& g : groups) {
+        std::vector<SimulationConfig> variants;
+        for (int k : g) {
+            results[k].name = scenarios[k].name;
+            results[k].output_dir = scenarios[k].config.output_dir;
+            variants.push_back(scenarios[k].config);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        try {
+            for (const auto& c : variants) {
+                std::filesystem::create_directories(c.output_dir);
+            }
+
+            EnsembleSimulation ensemble(variants);
+            ensemble.run();
+
+            for (size_t m = 0; m < g.size(); ++m) {
+                ensemble.exportResults(static_cast<int>(m));
+                results[g[m]].stats = ensemble.statistics(static_cast<int>(m));
+                results[g[m]].ok = true;
+            }
+        } catch (const std::exception& e) {
+            for (int k : g) {
+                results[k].error = e.what();
+            }
+            std::cerr << "Error: ensemble of " << g.size() << " scenarios: " << e.what() << std::endl;
+        }
+
+        // Wall time is shared by the whole group
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count() / g.size();
+        for (int k : g) {
+            results[k].seconds = seconds;
+        }
+    }
+
+    return results;
+}
+
+void printBatchSummary(const std::vector<BatchResult>& results, std::ostream& out) {
+    out << "\n=== Batch Summary ===" << std::endl;
+    out << std::left << std::setw(24) << "Scenario"
+        << std::right << std::setw(12) << "Peak T (K)"
+        << std::setw(14) << "Fusion (mm²)"
+        << std::setw(12) << "HAZ (mm²)"
+        << std::setw(10) << "Time (s)" << std::endl;
+
+    out << std::fixed << std::setprecision(1);
+    for (const auto& r : results) {
+        out << std::left << std::setw(24) << r.name << std::right;
+        if (r.ok) {
+            out << std::setw(12) << r.stats.T_peak
+                << std::setw(14) << r.stats.fusion_area * 1e6
+                << std::setw(12) << r.stats.HAZ_area * 1e6;
+        } else {
+            out << "  FAILED: " << r.error;
+        }
+        out << std::setw(10) << r.seconds << std::endl;
+    }
+    out << std::defaultfloat;
+}
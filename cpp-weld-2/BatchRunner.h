@@ -0,0 +1,51 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "WeldingSimulation.h"
+
+// One run of a batch
+struct BatchScenario {
+    std::string name;
+    SimulationConfig config;
+};
+
+// Outcome of one batch scenario
+struct BatchResult {
+    std::string name;
+    std::string output_dir;
+    SimulationStatistics stats;
+    double seconds = 0.0;
+    bool ok = false;
+    std::string error;
+};
+
+// Read a batch file. Each non-empty line that does not start with '#' is
+//   <name> [options...]
+// using the same options as the command line, applied on top of `base`.
+// Unless a line sets --output_dir, its results go to <base.output_dir>/<name>.
+// Throws std::runtime_error on unreadable files or invalid lines.
+std::vector<BatchScenario> readBatchFile(const std::string& filename,
+                                         const SimulationConfig& base);
+
+// Create the output directory (and video_frames/ if frames are saved)
+void prepareOutputDirectories(const SimulationConfig& config);
+
+// Run all scenarios in this process. Up to `jobs` scenarios run at once,
+// each with an equal share of the OpenMP threads; grids are built once per
+// geometry and shared. Each scenario logs to <output_dir>/simulation_log.txt.
+std::vector<BatchResult> runBatch(const std::vector<BatchScenario>& scenarios, int jobs);
+
+// Run all scenarios as ensembles: scenarios that share geometry, grid, dt
+// and T0 advance together in one EnsembleSimulation per group. Only
+// simulation_results.csv (T_final/T_max) is written per scenario; video,
+// snapshots, probes and checkpoints are ignored.
+std::vector<BatchResult> runEnsembleBatch(const std::vector<BatchScenario>& scenarios);
+
+// Table of peak temperature and zone areas per scenario
+void printBatchSummary(const std::vector<BatchResult>& results, std::ostream& out);
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,380 @@
+// Microbenchmarks of the solver's hot kernels.
+//
+// Times each kernel of WeldingSimulation in isolation over a range of grid
+// sizes and OpenMP thread counts and writes one JSON record per
+// (kernel, grid, threads) for tracking over time. Built as bench_welding;
+// not part of the CTest suite since the numbers depend on the machine.
+//
+// Kernels:
+//   heat_source     computeSourceTerm of the configured process: clear of last
+//                   step's window and banded accumulate over the new one
+//   heat_source_4   the same with four sources in tandem (overlapping windows)
+//   properties      computeMaterialProperties of the current field
+//   stencil         explicit update of solveTimeStep (applyStencil)
+//   accumulators    T_max_ and cooling accumulator update (updateAccumulators)
+//   export_results  exportResults (CSV + history, melt pool, zone map)
+//   export_frame    exportVideoFrame
+//
+// Each record has ns per cell, effective bandwidth from the bytes the kernel
+// must move per cell (file bytes for the exports; window bytes spread over
+// the grid for the sources) and the scaling efficiency
+// t1 / (p tp) against the single-thread time. The exports are serial and
+// are only timed at one thread, on grids up to --export_max_cells.
+
+#include "WeldingSimulation.h"
+#include "HeatSource.h"
+#include "BatchRunner.h"
+#include "Json.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <memory>
+#include <cmath>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <omp.h>
+
+namespace {
+
+const double DEFAULT_MIN_TIME = 0.2;          // s of repetitions per measurement
+const int MIN_REPETITIONS = 3;
+const long DEFAULT_EXPORT_MAX_CELLS = 1000000;
+const int TANDEM_SOURCES = 4;
+const double TANDEM_DELAY = 0.5;              // s between the tandem sources' starts
+
+struct BenchOptions {
+    std::vector<std::pair<int, int>> sizes = {{151, 101}, {501, 301}, {1001, 501}, {2001, 1001}, {4001, 2001}};
+    std::vector<int> threads;                 // Empty = 1, 2, 4, ... up to the OpenMP maximum
+    double min_time = DEFAULT_MIN_TIME;
+    long export_max_cells = DEFAULT_EXPORT_MAX_CELLS;
+    std::string output;                       // JSON file (empty = stdout)
+    std::string scratch_dir = "bench_output";
+};
+
+struct Measurement {
+    double seconds = 0.0;   // Best time of one call
+    int repetitions = 0;
+};
+
+// Best time of fn over at least MIN_REPETITIONS calls and min_time seconds
+Measurement measure(const std::function<void()>& fn, double min_time) {
+    fn();  // Warm-up: first touch, page faults, file creation
+
+    Measurement m;
+    m.seconds = 1e300;
+    double total = 0.0;
+    while (m.repetitions < MIN_REPETITIONS || total < min_time) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        m.seconds = std::min(m.seconds, s);
+        total += s;
+        ++m.repetitions;
+    }
+    return m;
+}
+
+std::vector<std::pair<int, int>> parseSizes(const std::string& text) {
+    std::vector<std::pair<int, int>> sizes;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t x = item.find('x');
+        if (x == std::string::npos) {
+            throw std::invalid_argument("Invalid grid size '" + item + "' (expected NXxNY)");
+        }
+        int nx = std::stoi(item.substr(0, x));
+        int ny = std::stoi(item.substr(x + 1));
+        if (nx < 3 || ny < 3) {
+            throw std::invalid_argument("Grid size '" + item + "' is too small");
+        }
+        sizes.emplace_back(nx, ny);
+    }
+    return sizes;
+}
+
+std::vector<int> parseThreads(const std::string& text) {
+    std::vector<int> threads;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        int p = std::stoi(item);
+        if (p < 1) {
+            throw std::invalid_argument("Invalid thread count '" + item + "'");
+        }
+        threads.push_back(p);
+    }
+    return threads;
+}
+
+std::vector<int> defaultThreads() {
+    const int max_threads = omp_get_max_threads();
+    std::vector<int> threads;
+    for (int p = 1; p < max_threads; p *= 2) {
+        threads.push_back(p);
+    }
+    threads.push_back(max_threads);
+    return threads;
+}
+
+uintmax_t directoryBytes(const std::string& dir) {
+    uintmax_t bytes = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file()) {
+            bytes += entry.file_size();
+        }
+    }
+    return bytes;
+}
+
+} // namespace
+
+// Friend of WeldingSimulation: sets up one solver per grid and times its
+// private kernels on a field with a hot spot under the arc, so that the
+// property lookup and the source see the same temperature ranges as a run.
+class KernelBenchmark {
+public:
+    KernelBenchmark(int nx, int ny, const BenchOptions& options) : options_(options) {
+        SimulationConfig c;
+        c.nx = nx;
+        c.ny = ny;
+        c.t_end = 10.0 * c.dt;   // Keeps the per-run buffers small
+        c.use_cache = false;
+        c.save_video_frames = true;
+        c.output_dir = options.scratch_dir;
+        prepareOutputDirectories(c);
+
+        sim_ = std::make_unique<WeldingSimulation>(c, nullptr, nullptr);
+        arcPosition(c, 1.0, x_arc_, y_arc_);
+
+        // Sources trailing each other along the path, as set by "sources"
+        for (int k = 0; k < TANDEM_SOURCES; ++k) {
+            SourceSpec spec;
+            spec.delay = k * TANDEM_DELAY;
+            const SimulationConfig ck = sourceConfig(c, spec);
+            tandem_.push_back({makeHeatSource(ck), TorchPath(ck), spec.delay});
+        }
+
+        // Gaussian hot spot from T0 up to above the melting range
+        const auto& X = sim_->X_;
+        const auto& Y = sim_->Y_;
+        std::vector<double> T(X.size());
+        for (size_t k = 0; k < T.size(); ++k) {
+            double r_sq = (X[k] - x_arc_) * (X[k] - x_arc_) + (Y[k] - y_arc_) * (Y[k] - y_arc_);
+            T[k] = c.T0 + 2500.0 * std::exp(-r_sq / (2.0 * 0.01 * 0.01));
+        }
+        sim_->setInitialTemperature(T);
+
+        // Fill every scratch buffer once, as one solver step would; the
+        // source windows give the bytes the source kernels move
+        WeldingSimulation& s = *sim_;
+        computeTandem();
+        source_bytes_[1] = windowBytes();
+        s.computeSourceTerm(1.0);
+        source_bytes_[0] = windowBytes();
+        s.computeMaterialProperties(s.T_, s.k_arr_, s.cp_arr_, s.rho_arr_);
+        s.applyStencil(s.Qvol_);
+    }
+
+    // Kernel name -> (bytes moved per cell, call)
+    std::vector<std::tuple<std::string, double, std::function<void()>>> kernels() {
+        WeldingSimulation& s = *sim_;
+        const double d = sizeof(double);
+        return {
+            // Clears last step's window of Qvol, then reads and writes it
+            {"heat_source", source_bytes_[0], [&s] { s.computeSourceTerm(1.0); }},
+            {"heat_source_" + std::to_string(TANDEM_SOURCES), source_bytes_[1], [this] { computeTandem(); }},
+            // Reads T; writes k, cp, rho
+            {"properties", 4 * d, [&s] { s.computeMaterialProperties(s.T_, s.k_arr_, s.cp_arr_, s.rho_arr_); }},
+            // Reads T, k, cp, rho, Qvol; writes T_new
+            {"stencil", 6 * d, [&s] { s.applyStencil(s.Qvol_); }},
+            // Reads T, T_old and five accumulators; writes T_max, cool_rate_max
+            // (the other three only change near the arc)
+            {"accumulators", 9 * d, [&s] { s.updateAccumulators(1.0, s.T_new_); }},
+        };
+    }
+
+    Measurement exportResults(double& bytes) {
+        Measurement m = measure([this] { sim_->exportResults("_bench"); }, options_.min_time);
+        bytes = static_cast<double>(directoryBytes(options_.scratch_dir) - frameBytes());
+        return m;
+    }
+
+    Measurement exportFrame(double& bytes) {
+        Measurement m = measure([this] { sim_->exportVideoFrame(0, 1.0); }, options_.min_time);
+        bytes = static_cast<double>(frameBytes());
+        return m;
+    }
+
+private:
+    const BenchOptions& options_;
+    std::unique_ptr<WeldingSimulation> sim_;
+    double x_arc_ = 0.0, y_arc_ = 0.0;
+    std::vector<WeldingSimulation::Torch> tandem_;
+    double source_bytes_[2] = {0.0, 0.0};   // Per grid cell: one source, tandem
+
+    // computeSourceTerm() with the tandem sources in place of the configured
+    // one, at a time when all of them are on the plate
+    void computeTandem() {
+        WeldingSimulation& s = *sim_;
+        std::swap(s.torches_, tandem_);
+        s.computeSourceTerm(1.0 + (TANDEM_SOURCES - 1) * TANDEM_DELAY);
+        std::swap(s.torches_, tandem_);
+    }
+
+    // Qvol bytes moved by the last computeSourceTerm() (clear, then read and
+    // write per source), per cell of the grid
+    double windowBytes() const {
+        double cells = 0.0;
+        for (const CellWindow& w : sim_->source_windows_) {
+            cells += static_cast<double>(w.i1 - w.i0 + 1) * (w.j1 - w.j0 + 1);
+        }
+        return 3 * sizeof(double) * cells / (static_cast<double>(sim_->nx_) * sim_->ny_);
+    }
+
+    uintmax_t frameBytes() const {
+        std::string frame = options_.scratch_dir + "/video_frames/frame_0.csv";
+        return std::filesystem::exists(frame) ? std::filesystem::file_size(frame) : 0;
+    }
+};
+
+namespace {
+
+JsonValue record(const std::string& kernel, int nx, int ny, int threads, const Measurement& m,
+                 double bytes_per_cell, double t1) {
+    const double cells = static_cast<double>(nx) * ny;
+    JsonValue r = JsonValue::makeObject();
+    r.set("kernel", JsonValue::makeString(kernel));
+    r.set("nx", JsonValue::makeNumber(nx));
+    r.set("ny", JsonValue::makeNumber(ny));
+    r.set("threads", JsonValue::makeNumber(threads));
+    r.set("ns_per_cell", JsonValue::makeNumber(m.seconds / cells * 1e9));
+    r.set("gb_per_s", JsonValue::makeNumber(bytes_per_cell * cells / m.seconds / 1e9));
+    r.set("scaling_efficiency", JsonValue::makeNumber(t1 / (threads * m.seconds)));
+    r.set("seconds", JsonValue::makeNumber(m.seconds));
+    r.set("repetitions", JsonValue::makeNumber(m.repetitions));
+    return r;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --sizes <NXxNY,...>        Grids (default 151x101,501x301,1001x501,2001x1001,4001x2001)\n"
+              << "  --threads <p,...>          Thread counts (default 1,2,4,... up to the OpenMP maximum)\n"
+              << "  --min_time <s>             Minimum timed seconds per measurement (default "
+              << DEFAULT_MIN_TIME << ")\n"
+              << "  --export_max_cells <n>     Largest grid for the export kernels (default "
+              << DEFAULT_EXPORT_MAX_CELLS << ")\n"
+              << "  --scratch_dir <dir>        Directory for exported files (default bench_output)\n"
+              << "  --output <file.json>       Write the JSON report to a file (default stdout)"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (i + 1 >= argc) {
+                printUsage(argv[0]);
+                return 1;
+            } else if (arg == "--sizes") {
+                options.sizes = parseSizes(argv[++i]);
+            } else if (arg == "--threads") {
+                options.threads = parseThreads(argv[++i]);
+            } else if (arg == "--min_time") {
+                options.min_time = std::stod(argv[++i]);
+            } else if (arg == "--export_max_cells") {
+                options.export_max_cells = std::stol(argv[++i]);
+            } else if (arg == "--scratch_dir") {
+                options.scratch_dir = argv[++i];
+            } else if (arg == "--output") {
+                options.output = argv[++i];
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (options.threads.empty()) {
+        options.threads = defaultThreads();
+    }
+
+    const int max_threads = omp_get_max_threads();
+    JsonValue results = JsonValue::makeArray();
+
+    try {
+        for (const auto& size : options.sizes) {
+            const int nx = size.first;
+            const int ny = size.second;
+            std::cerr << "Grid " << nx << "x" << ny << std::endl;
+            KernelBenchmark bench(nx, ny, options);
+
+            for (auto& kernel : bench.kernels()) {
+                const std::string& name = std::get<0>(kernel);
+                double t1 = 0.0;
+                for (int p : options.threads) {
+                    omp_set_num_threads(p);
+                    Measurement m = measure(std::get<2>(kernel), options.min_time);
+                    if (t1 == 0.0) {
+                        // Reference from the first count (ideal single-thread time if p > 1)
+                        t1 = m.seconds * p;
+                    }
+                    results.array.push_back(record(name, nx, ny, p, m, std::get<1>(kernel), t1));
+                    std::cerr << "  " << name << " p=" << p << ": " << m.seconds / (double(nx) * ny) * 1e9
+                              << " ns/cell" << std::endl;
+                }
+            }
+            omp_set_num_threads(max_threads);
+
+            if (static_cast<long>(nx) * ny <= options.export_max_cells) {
+                double bytes = 0.0;
+                Measurement m = bench.exportResults(bytes);
+                results.array.push_back(record("export_results", nx, ny, 1, m,
+                                               bytes / (double(nx) * ny), m.seconds));
+                m = bench.exportFrame(bytes);
+                results.array.push_back(record("export_frame", nx, ny, 1, m,
+                                               bytes / (double(nx) * ny), m.seconds));
+            }
+        }
+        std::filesystem::remove_all(options.scratch_dir);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    JsonValue report = JsonValue::makeObject();
+    report.set("benchmark", JsonValue::makeString("welding_kernels"));
+    report.set("solver_version", JsonValue::makeString(SOLVER_VERSION));
+    report.set("max_threads", JsonValue::makeNumber(max_threads));
+    report.set("min_time", JsonValue::makeNumber(options.min_time));
+    report.set("results", results);
+
+    if (options.output.empty()) {
+        writeJson(std::cout, report);
+        std::cout << std::endl;
+    } else {
+        std::ofstream out(options.output);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not open file " << options.output << std::endl;
+            return 1;
+        }
+        writeJson(out, report);
+        out << std::endl;
+        std::cerr << "Report written to " << options.output << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,455 @@
+#include "Calibration.h"
+#include "ConfigLoader.h"
+#include "ThreadPool.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <map>
+#include <omp.h>
+
+namespace {
+
+// Read a "time,T" CSV trace; a non-numeric first line is a header
+void readCurveFile(const std::string& filename, MeasuredCurve& curve) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open measurement file " + filename);
+    }
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream ss(line);
+        std::string t_text, T_text;
+        std::getline(ss, t_text, ',');
+        std::getline(ss, T_text, ',');
+        try {
+            size_t used_t = 0, used_T = 0;
+            double t = std::stod(t_text, &used_t);
+            double T = std::stod(T_text, &used_T);
+            if (!curve.time.empty() && t <= curve.time.back()) {
+                throw std::runtime_error(filename + ":" + std::to_string(line_number) +
+                                         ": times must increase");
+            }
+            curve.time.push_back(t);
+            curve.T.push_back(T);
+        } catch (const std::runtime_error&) {
+            throw;
+        } catch (const std::exception&) {
+            if (line_number == 1) {
+                continue;  // Header
+            }
+            throw std::runtime_error(filename + ":" + std::to_string(line_number) +
+                                     ": expected 'time,T'");
+        }
+    }
+
+    if (curve.time.empty()) {
+        throw std::runtime_error(filename + ": no samples");
+    }
+}
+
+// Simulated temperature at time t, linear between history rows. The field
+// starts at T0 at t = 0, before the first recorded row.
+double sampleHistory(const ThermalHistory& history, int k, double t, double T0) {
+    const int rows = history.size();
+    double t_prev = 0.0, T_prev = T0;
+    // Rows are evenly spaced, so start the search near the expected row
+    int row = 0;
+    if (rows > 1) {
+        double spacing = history.time(1) - history.time(0);
+        row = std::max(0, std::min(rows - 1, static_cast<int>(t / spacing) - 1));
+        while (row > 0 && history.time(row) > t) {
+            --row;
+        }
+    }
+    for (; row < rows; ++row) {
+        double t_row = history.time(row);
+        double T_row = history.value(k, row);
+        if (t_row >= t) {
+            if (row > 0) {
+                t_prev = history.time(row - 1);
+                T_prev = history.value(k, row - 1);
+            }
+            return T_prev + (T_row - T_prev) * (t - t_prev) / (t_row - t_prev);
+        }
+    }
+    return std::numeric_limits<double>::quiet_NaN();  // After the end of the run
+}
+
+class Calibrator {
+public:
+    Calibrator(const CalibrationProblem& problem, int jobs, std::ostream& log)
+        : problem_(problem), jobs_(std::max(1, jobs)), log_(log) {
+
+        base_ = problem.base;
+        base_.probes.clear();
+        for (const auto& m : problem.measurements) {
+            ProbeSpec probe;
+            probe.name = m.name;
+            probe.x = m.x;
+            probe.y = m.y;
+            base_.probes.push_back(probe);
+        }
+        base_.save_video_frames = false;
+        base_.snapshot_time = -1.0;
+        base_.history_chunk_rows = 0;
+        base_.checkpoint_interval = 0;
+        base_.restart_file.clear();
+
+        if (base_.t_end <= 0) {
+            for (const auto& m : problem.measurements) {
+                base_.t_end = std::max(base_.t_end, m.time.back());
+            }
+        }
+
+        grid_ = makeGrid(base_);
+        threads_per_job_ = std::max(1, omp_get_max_threads() / jobs_);
+
+        log_ << "evaluation";
+        for (const auto& p : problem.parameters) {
+            log_ << "," << p.name;
+        }
+        log_ << ",rms" << std::endl;
+        log_ << std::setprecision(10);
+    }
+
+    int forwardSolves() const { return static_cast<int>(memo_.size()); }
+
+    // Physical values of normalized point u
+    std::vector<double> denormalize(const std::vector<double>& u) const {
+        std::vector<double> x(u.size());
+        for (size_t k = 0; k < u.size(); ++k) {
+            const auto& p = problem_.parameters[k];
+            x[k] = p.min + u[k] * (p.max - p.min);
+        }
+        return x;
+    }
+
+    SimulationConfig configFor(const std::vector<double>& u) const {
+        SimulationConfig c = base_;
+        std::vector<double> x = denormalize(u);
+        for (size_t k = 0; k < x.size(); ++k) {
+            setConfigValue(c, problem_.parameters[k].name, x[k]);
+        }
+        return c;
+    }
+
+    // Solve every point not seen before; concurrently when jobs > 1
+    void prefetch(const std::vector<std::vector<double>>& points) {
+        std::vector<std::vector<double>> missing;
+        for (const auto& u : points) {
+            if (memo_.find(u) == memo_.end() &&
+                std::find(missing.begin(), missing.end(), u) == missing.end()) {
+                missing.push_back(u);
+            }
+        }
+        if (missing.empty()) {
+            return;
+        }
+
+        std::vector<double> rms(missing.size());
+        if (jobs_ == 1 || missing.size() == 1) {
+            for (size_t k = 0; k < missing.size(); ++k) {
+                rms[k] = misfit(missing[k]);
+            }
+        } else {
+            ThreadPool pool(std::min<int>(jobs_, static_cast<int>(missing.size())));
+            for (size_t k = 0; k < missing.size(); ++k) {
+                pool.submit([&, k]() {
+                    omp_set_num_threads(threads_per_job_);
+                    rms[k] = misfit(missing[k]);
+                });
+            }
+            pool.wait();
+        }
+
+        for (size_t k = 0; k < missing.size(); ++k) {
+            memo_[missing[k]] = rms[k];
+
+            log_ << memo_.size();
+            for (double x : denormalize(missing[k])) {
+                log_ << "," << x;
+            }
+            log_ << "," << rms[k] << std::endl;
+        }
+    }
+
+    double value(const std::vector<double>& u) {
+        prefetch({u});
+        return memo_.at(u);
+    }
+
+private:
+    const CalibrationProblem& problem_;
+    int jobs_;
+    int threads_per_job_ = 1;
+    std::ostream& log_;
+    SimulationConfig base_;
+    std::shared_ptr<const SimulationGrid> grid_;
+    std::map<std::vector<double>, double> memo_;
+
+    // RMS misfit over all measured samples inside the simulated time;
+    // infinite if the run fails (e.g. an unstable parameter combination)
+    double misfit(const std::vector<double>& u) const {
+        try {
+            SimulationConfig c = configFor(u);
+            WeldingSimulation sim(c, grid_, nullptr);
+            sim.run();
+
+            const ThermalHistory& history = sim.history();
+            double sum = 0.0;
+            size_t count = 0;
+            for (size_t m = 0; m < problem_.measurements.size(); ++m) {
+                const MeasuredCurve& curve = problem_.measurements[m];
+                for (size_t s = 0; s < curve.time.size(); ++s) {
+                    double T_sim = sampleHistory(history, static_cast<int>(m), curve.time[s], c.T0);
+                    if (std::isnan(T_sim)) {
+                        continue;
+                    }
+                    double r = T_sim - curve.T[s];
+                    sum += r * r;
+                    ++count;
+                }
+            }
+            if (count == 0) {
+                return std::numeric_limits<double>::infinity();
+            }
+            return std::sqrt(sum / count);
+        } catch (const std::exception&) {
+            return std::numeric_limits<double>::infinity();
+        }
+    }
+};
+
+std::vector<double> clampUnit(std::vector<double> u) {
+    for (double& v : u) {
+        v = std::min(1.0, std::max(0.0, v));
+    }
+    return u;
+}
+
+// a + s * (b - a), clamped to the unit box
+std::vector<double> along(const std::vector<double>& a, const std::vector<double>& b, double s) {
+    std::vector<double> u(a.size());
+    for (size_t k = 0; k < a.size(); ++k) {
+        u[k] = a[k] + s * (b[k] - a[k]);
+    }
+    return clampUnit(u);
+}
+
+} // namespace
+
+CalibrationProblem readCalibrationFile(const std::string& filename, const SimulationConfig& base) {
+    JsonValue root = readJsonFile(filename);
+    CalibrationProblem problem;
+    problem.base = base;
+
+    const std::filesystem::path directory = std::filesystem::path(filename).parent_path();
+
+    try {
+        if (!root.isObject()) {
+            throw std::runtime_error("calibration file must be a JSON object");
+        }
+
+        for (const auto& member : root.object) {
+            const std::string& key = member.first;
+            const JsonValue& v = member.second;
+
+            if (key == "config") {
+                applyConfigJson(v, problem.base);
+            } else if (key == "max_evaluations") {
+                problem.max_evaluations = static_cast<int>(requireNumber(v, key));
+            } else if (key == "tolerance") {
+                problem.tolerance = requireNumber(v, key);
+            } else if (key == "measurements") {
+                if (!v.isArray()) {
+                    throw std::runtime_error("measurements: expected an array");
+                }
+                for (size_t k = 0; k < v.array.size(); ++k) {
+                    const JsonValue& item = v.array[k];
+                    const std::string where = "measurements[" + std::to_string(k) + "]";
+                    const JsonValue* x = item.find("x");
+                    const JsonValue* y = item.find("y");
+                    const JsonValue* file = item.find("file");
+                    const JsonValue* name = item.find("name");
+                    if (!x || !y || !file || !file->isString()) {
+                        throw std::runtime_error(where + ": x, y and file are required");
+                    }
+
+                    MeasuredCurve curve;
+                    curve.name = (name && name->isString()) ? name->string : "tc" + std::to_string(k + 1);
+                    curve.x = requireNumber(*x, where + ".x");
+                    curve.y = requireNumber(*y, where + ".y");
+
+                    std::filesystem::path path(file->string);
+                    if (path.is_relative()) {
+                        path = directory / path;
+                    }
+                    readCurveFile(path.string(), curve);
+                    problem.measurements.push_back(curve);
+                }
+            } else if (key == "parameters") {
+                if (!v.isObject()) {
+                    throw std::runtime_error("parameters: expected an object");
+                }
+                for (const auto& param : v.object) {
+                    const std::string where = "parameters." + param.first;
+                    const JsonValue* min = param.second.find("min");
+                    const JsonValue* max = param.second.find("max");
+                    const JsonValue* initial = param.second.find("initial");
+                    if (!min || !max) {
+                        throw std::runtime_error(where + ": min and max are required");
+                    }
+
+                    CalibrationParameter p;
+                    p.name = param.first;
+                    p.min = requireNumber(*min, where + ".min");
+                    p.max = requireNumber(*max, where + ".max");
+                    p.initial = initial ? requireNumber(*initial, where + ".initial")
+                                        : 0.5 * (p.min + p.max);
+                    if (!(p.max > p.min) || p.initial < p.min || p.initial > p.max) {
+                        throw std::runtime_error(where + ": need min < max and initial within them");
+                    }
+                    problem.parameters.push_back(p);
+                }
+            } else {
+                throw std::runtime_error("unknown key '" + key + "'");
+            }
+        }
+
+        if (problem.measurements.empty()) {
+            throw std::runtime_error("no measurements");
+        }
+        if (problem.parameters.empty()) {
+            throw std::runtime_error("no parameters to fit");
+        }
+
+        for (const auto& p : problem.parameters) {
+            validateParameterName(problem.base, p.name);  // Rejects unknown names early
+        }
+    } catch (const std::exception& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+
+    return problem;
+}
+
+CalibrationResult calibrate(const CalibrationProblem& problem, int jobs, std::ostream& log) {
+    const size_t n = problem.parameters.size();
+    Calibrator calibrator(problem, jobs, log);
+
+    // Work in the unit box; the initial simplex steps 10% of each range
+    std::vector<double> u0(n);
+    for (size_t k = 0; k < n; ++k) {
+        const auto& p = problem.parameters[k];
+        u0[k] = (p.initial - p.min) / (p.max - p.min);
+    }
+
+    std::vector<std::vector<double>> simplex = {u0};
+    for (size_t k = 0; k < n; ++k) {
+        std::vector<double> u = u0;
+        u[k] += (u[k] + 0.1 <= 1.0) ? 0.1 : -0.1;
+        simplex.push_back(u);
+    }
+    calibrator.prefetch(simplex);
+
+    CalibrationResult result;
+    result.initial_rms = calibrator.value(u0);
+
+    std::vector<double> f(n + 1);
+    while (true) {
+        // Order vertices best to worst
+        for (size_t k = 0; k <= n; ++k) {
+            f[k] = calibrator.value(simplex[k]);
+        }
+        std::vector<size_t> order(n + 1);
+        for (size_t k = 0; k <= n; ++k) {
+            order[k] = k;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return f[a] < f[b]; });
+        std::vector<std::vector<double>> sorted;
+        std::vector<double> f_sorted;
+        for (size_t k : order) {
+            sorted.push_back(simplex[k]);
+            f_sorted.push_back(f[k]);
+        }
+        simplex = sorted;
+        f = f_sorted;
+
+        double size = 0.0;
+        for (size_t k = 1; k <= n; ++k) {
+            for (size_t d = 0; d < n; ++d) {
+                size = std::max(size, std::fabs(simplex[k][d] - simplex[0][d]));
+            }
+        }
+        if ((std::isfinite(f[n]) && f[n] - f[0] < problem.tolerance) || size < 1e-6) {
+            result.converged = true;
+            break;
+        }
+        if (calibrator.forwardSolves() >= problem.max_evaluations) {
+            break;
+        }
+        ++result.iterations;
+
+        // Centroid of all but the worst vertex
+        std::vector<double> centroid(n, 0.0);
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t d = 0; d < n; ++d) {
+                centroid[d] += simplex[k][d] / n;
+            }
+        }
+        const std::vector<double>& worst = simplex[n];
+        const std::vector<double> reflected = along(centroid, worst, -1.0);
+        const std::vector<double> expanded = along(centroid, worst, -2.0);
+        const std::vector<double> outside = along(centroid, worst, -0.5);
+        const std::vector<double> inside = along(centroid, worst, 0.5);
+
+        if (jobs > 1) {
+            calibrator.prefetch({reflected, expanded, outside, inside});
+        }
+
+        const double f_r = calibrator.value(reflected);
+        if (f_r < f[0]) {
+            const double f_e = calibrator.value(expanded);
+            simplex[n] = (f_e < f_r) ? expanded : reflected;
+            continue;
+        }
+        if (f_r < f[n - 1]) {
+            simplex[n] = reflected;
+            continue;
+        }
+
+        const std::vector<double>& contracted = (f_r < f[n]) ? outside : inside;
+        const double f_c = calibrator.value(contracted);
+        if (f_c < std::min(f_r, f[n])) {
+            simplex[n] = contracted;
+            continue;
+        }
+
+        // Shrink towards the best vertex
+        for (size_t k = 1; k <= n; ++k) {
+            simplex[k] = along(simplex[0], simplex[k], 0.5);
+        }
+        calibrator.prefetch(std::vector<std::vector<double>>(simplex.begin() + 1, simplex.end()));
+    }
+
+    result.values = calibrator.denormalize(simplex[0]);
+    result.rms = f[0];
+    result.forward_solves = calibrator.forwardSolves();
+    result.config = problem.base;
+    for (size_t k = 0; k < n; ++k) {
+        setConfigValue(result.config, problem.parameters[k].name, result.values[k]);
+    }
+    return result;
+}
@@ -0,0 +1,74 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "WeldingSimulation.h"
+
+// Measured thermocouple trace at a position on the plate
+struct MeasuredCurve {
+    std::string name;
+    double x = 0.0;
+    double y = 0.0;
+    std::vector<double> time;  // s, increasing
+    std::vector<double> T;     // K
+};
+
+// Parameter fitted within a box
+struct CalibrationParameter {
+    std::string name;          // setConfigValue() name: "eta", "a", "b", "ff", ...
+    double min = 0.0;
+    double max = 0.0;
+    double initial = 0.0;
+};
+
+// Calibration problem, read from a JSON file:
+//
+//   {
+//     "config": { ... },                     (config.json document for the base case)
+//     "measurements": [
+//       { "name": "tc1", "x": 0.06, "y": 0.008, "file": "tc1.csv" }, ...
+//     ],
+//     "parameters": {
+//       "a": { "min": 0.002, "max": 0.010, "initial": 0.005 }, ...
+//     },
+//     "max_evaluations": 200,
+//     "tolerance": 0.01                      (K; stop when the simplex RMS spread is below it)
+//   }
+//
+// Measurement files are CSV "time,T" (s, K); a header line is allowed and
+// relative paths are resolved against the calibration file. Runs stop at
+// the last measured time unless the config sets t_end.
+struct CalibrationProblem {
+    SimulationConfig base;
+    std::vector<MeasuredCurve> measurements;
+    std::vector<CalibrationParameter> parameters;
+    int max_evaluations = 200;
+    double tolerance = 0.01;
+};
+
+struct CalibrationResult {
+    std::vector<double> values;    // Fitted parameters, in problem order
+    double rms = 0.0;              // RMS misfit at the fit (K)
+    double initial_rms = 0.0;      // RMS misfit at the initial guess (K)
+    int forward_solves = 0;        // Distinct simulations run
+    int iterations = 0;
+    bool converged = false;
+    SimulationConfig config;       // Base configuration with the fitted values
+};
+
+// Throws std::runtime_error on unreadable files or invalid problems
+CalibrationProblem readCalibrationFile(const std::string& filename, const SimulationConfig& base);
+
+// Fit the parameters by bounded Nelder-Mead on the RMS misfit between the
+// measured curves and probes placed at the same positions. With jobs > 1 the
+// reflection, expansion and both contraction candidates of each iteration
+// (and the points of a shrink) are solved concurrently on a thread pool, so
+// an iteration costs one run of wall time. Candidates are memoized and
+// simulations go through the result cache. Each evaluation is appended to
+// `log` as CSV.
+CalibrationResult calibrate(const CalibrationProblem& problem, int jobs, std::ostream& log);
+
+#endif // CALIBRATION_H
@@ -0,0 +1,175 @@
+#include "Checkpoint.h"
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char CHECKPOINT_MAGIC[8] = {'W', 'E', 'L', 'D', 'C', 'K', 'P', 'T'};
+const std::uint32_t CHECKPOINT_VERSION = 4;
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeArray(std::ofstream& out, const std::vector<T>& data) {
+    std::uint64_t n = data.size();
+    writeValue(out, n);
+    out.write(reinterpret_cast<const char*>(data.data()), n * sizeof(T));
+}
+
+template <typename T>
+void readValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void readArray(std::ifstream& in, std::vector<T>& data) {
+    std::uint64_t n = 0;
+    readValue(in, n);
+    if (!in || n > (1ull << 40)) {
+        throw std::runtime_error("corrupt array length");
+    }
+    data.resize(n);
+    in.read(reinterpret_cast<char*>(data.data()), n * sizeof(T));
+}
+
+} // namespace
+
+void writeCheckpointFile(const std::string& filename, const CheckpointState& state) {
+    const std::string tmp_name = filename + ".tmp";
+
+    std::ofstream out(tmp_name, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open checkpoint file " + tmp_name);
+    }
+
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    writeValue(out, CHECKPOINT_VERSION);
+    writeValue(out, state.config_hash);
+    writeValue(out, state.step);
+    writeValue(out, state.time);
+    writeValue(out, state.nx);
+    writeValue(out, state.ny);
+
+    writeArray(out, state.T);
+    writeArray(out, state.T_max);
+    writeArray(out, state.t_high);
+    writeArray(out, state.t_low);
+    writeArray(out, state.cool_rate_max);
+    writeArray(out, state.time_above_crit);
+    writeArray(out, state.fusion_words);
+    writeArray(out, state.crit_words);
+    writeArray(out, state.hot_box);
+    writeArray(out, state.melt_pool);
+
+    writeValue(out, state.history_series);
+    writeValue(out, state.history_rows_streamed);
+    writeValue(out, state.history_stream_bytes);
+    writeArray(out, state.history_time);
+    writeArray(out, state.history_values);
+
+    out.close();
+    if (!out) {
+        std::remove(tmp_name.c_str());
+        throw std::runtime_error("Failed while writing checkpoint " + tmp_name);
+    }
+
+    // rename() replaces the destination atomically, so a crash never
+    // leaves a half-written checkpoint under the real name
+    if (std::rename(tmp_name.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp_name.c_str());
+        throw std::runtime_error("Could not rename checkpoint to " + filename);
+    }
+}
+
+CheckpointState readCheckpointFile(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Could not open checkpoint file " + filename);
+    }
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error(filename + " is not a welding checkpoint");
+    }
+
+    std::uint32_t version = 0;
+    readValue(in, version);
+    if (version != CHECKPOINT_VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(version) +
+                                 " in " + filename);
+    }
+
+    CheckpointState state;
+    try {
+        readValue(in, state.config_hash);
+        readValue(in, state.step);
+        readValue(in, state.time);
+        readValue(in, state.nx);
+        readValue(in, state.ny);
+
+        readArray(in, state.T);
+        readArray(in, state.T_max);
+        readArray(in, state.t_high);
+        readArray(in, state.t_low);
+        readArray(in, state.cool_rate_max);
+        readArray(in, state.time_above_crit);
+        readArray(in, state.fusion_words);
+        readArray(in, state.crit_words);
+        readArray(in, state.hot_box);
+        readArray(in, state.melt_pool);
+
+        readValue(in, state.history_series);
+        readValue(in, state.history_rows_streamed);
+        readValue(in, state.history_stream_bytes);
+        readArray(in, state.history_time);
+        readArray(in, state.history_values);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Truncated checkpoint " + filename + " (" + e.what() + ")");
+    }
+
+    if (!in) {
+        throw std::runtime_error("Truncated checkpoint " + filename);
+    }
+
+    return state;
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    wait();
+}
+
+bool CheckpointWriter::busy() const {
+    return pending_.valid() &&
+           pending_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+bool CheckpointWriter::submit(CheckpointState state, const std::string& filename) {
+    if (busy()) {
+        return false;
+    }
+    wait();  // Collect the finished previous write
+
+    pending_ = std::async(std::launch::async,
+                          [state = std::move(state), filename]() {
+        try {
+            writeCheckpointFile(filename, state);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+    });
+    return true;
+}
+
+void CheckpointWriter::wait() {
+    if (pending_.valid()) {
+        pending_.get();
+    }
+}
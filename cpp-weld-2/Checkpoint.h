@@ -0,0 +1,75 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <future>
+
+// Complete solver state needed to resume a run
+struct CheckpointState {
+    std::uint64_t config_hash = 0;  // configHash() of the run that wrote it
+    int step = 0;                   // Last completed time step
+    double time = 0.0;              // Simulation time after that step
+    int nx = 0;
+    int ny = 0;
+
+    std::vector<double> T;          // Current temperature
+    std::vector<double> T_max;      // Peak temperature
+
+    // Cooling accumulators
+    std::vector<double> t_high;
+    std::vector<double> t_low;
+    std::vector<double> cool_rate_max;
+    std::vector<double> time_above_crit;
+
+    // Zone tracker: packed zone bits, hot box and melt pool samples
+    std::vector<std::uint64_t> fusion_words;
+    std::vector<std::uint64_t> crit_words;
+    std::vector<int> hot_box;
+    std::vector<double> melt_pool;
+
+    // Thermal history rows still held in memory (series-major values)
+    std::vector<double> history_time;
+    std::vector<double> history_values;
+    std::uint64_t history_series = 0;
+
+    // Streaming history: rows already written and the stream file size
+    std::uint64_t history_rows_streamed = 0;
+    std::uint64_t history_stream_bytes = 0;
+};
+
+// Write a checkpoint to <filename>.tmp and atomically rename it into place.
+// Throws std::runtime_error on I/O failure.
+void writeCheckpointFile(const std::string& filename, const CheckpointState& state);
+
+// Read a checkpoint. Throws std::runtime_error if the file is missing,
+// truncated or not a checkpoint.
+CheckpointState readCheckpointFile(const std::string& filename);
+
+// Writes checkpoints on a background thread so the time loop never waits
+// for the disk. At most one write is in flight; a checkpoint requested
+// while the previous one is still being written is skipped.
+class CheckpointWriter {
+public:
+    CheckpointWriter() = default;
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    // True while a previously submitted write is still running
+    bool busy() const;
+
+    // Start writing in the background. Returns false (and drops the state)
+    // if a previous write is still pending.
+    bool submit(CheckpointState state, const std::string& filename);
+
+    // Block until the pending write (if any) has finished
+    void wait();
+
+private:
+    std::future<void> pending_;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,203 @@
+#include "CommandLine.h"
+#include "ConfigLoader.h"
+#include "HeatSource.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+double toDouble(const std::string& option, const std::string& value) {
+    try {
+        size_t used = 0;
+        double result = std::stod(value, &used);
+        if (used == value.size()) {
+            return result;
+        }
+    } catch (const std::exception&) {
+    }
+    throw std::invalid_argument("Invalid value '" + value + "' for " + option);
+}
+
+int toInt(const std::string& option, const std::string& value) {
+    try {
+        size_t used = 0;
+        int result = std::stoi(value, &used);
+        if (used == value.size()) {
+            return result;
+        }
+    } catch (const std::exception&) {
+    }
+    throw std::invalid_argument("Invalid value '" + value + "' for " + option);
+}
+
+} // namespace
+
+std::vector<std::string> tokenize(const std::string& line) {
+    std::istringstream ss(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (ss >> token) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+bool applyConfigOption(const std::vector<std::string>& args, size_t& i,
+                       SimulationConfig& config) {
+    const std::string& opt = args[i];
+    const bool has_value = i + 1 < args.size();
+
+    if (opt == "--config" && has_value) {
+        loadConfigFile(args[++i], config);
+    } else if (opt == "--weld_process" && has_value) {
+        config.weld_process = args[++i];
+        if (!isWeldProcess(config.weld_process)) {
+            throw std::invalid_argument("Invalid weld_process. Use TIG, Electrode, Custom, EBW, LBW, PAW, SAW or ERW.");
+        }
+    } else if (opt == "--use_gas") {
+        config.use_gas = true;
+    } else if (opt == "--no-gas") {
+        config.use_gas = false;
+    } else if (opt == "--constant_properties") {
+        config.constant_properties = true;
+    } else if (opt == "--snapshot_time" && has_value) {
+        config.snapshot_time = toDouble(opt, args[++i]);
+    }
+    // Physical parameters
+    else if (opt == "--current" && has_value) {
+        config.I = toDouble(opt, args[++i]);
+    } else if (opt == "--voltage" && has_value) {
+        config.V = toDouble(opt, args[++i]);
+    } else if (opt == "--speed" && has_value) {
+        config.v_weld = toDouble(opt, args[++i]);
+    } else if (opt == "--eta" && has_value) {
+        config.eta = toDouble(opt, args[++i]);
+    } else if (opt == "--x_start" && has_value) {
+        config.x_start = toDouble(opt, args[++i]);
+    } else if (opt == "--y_arc" && has_value) {
+        config.y_arc = toDouble(opt, args[++i]);
+    } else if (opt == "--weld_direction" && has_value) {
+        config.weld_direction = args[++i];
+        if (config.weld_direction != "x" && config.weld_direction != "y") {
+            throw std::invalid_argument("Invalid weld_direction. Use 'x' or 'y'.");
+        }
+    }
+    // Goldak heat source
+    else if (opt == "--a" && has_value) {
+        config.a = toDouble(opt, args[++i]);
+    } else if (opt == "--b" && has_value) {
+        config.b = toDouble(opt, args[++i]);
+    } else if (opt == "--cf" && has_value) {
+        config.cf = toDouble(opt, args[++i]);
+    } else if (opt == "--cr" && has_value) {
+        config.cr = toDouble(opt, args[++i]);
+    } else if (opt == "--ff" && has_value) {
+        config.ff = toDouble(opt, args[++i]);
+    } else if (opt == "--fr" && has_value) {
+        config.fr = toDouble(opt, args[++i]);
+    }
+    // Beam and resistance sources
+    else if (opt == "--Q_beam" && has_value) {
+        config.Q_beam = toDouble(opt, args[++i]);
+    } else if (opt == "--R_beam" && has_value) {
+        config.R_beam = toDouble(opt, args[++i]);
+    } else if (opt == "--H_beam" && has_value) {
+        config.H_beam = toDouble(opt, args[++i]);
+    } else if (opt == "--erw_current_density" && has_value) {
+        config.erw_current_density = toDouble(opt, args[++i]);
+    } else if (opt == "--erw_sigma_e" && has_value) {
+        config.erw_sigma_e = toDouble(opt, args[++i]);
+    } else if (opt == "--erw_contact_width" && has_value) {
+        config.erw_contact_width = toDouble(opt, args[++i]);
+    } else if (opt == "--erw_contact_resistance" && has_value) {
+        config.erw_contact_resistance = toDouble(opt, args[++i]);
+    } else if (opt == "--erw_melt_factor" && has_value) {
+        config.erw_melt_factor = toDouble(opt, args[++i]);
+    }
+    // Domain, mesh and time step
+    else if (opt == "--Lx" && has_value) {
+        config.Lx = toDouble(opt, args[++i]);
+    } else if (opt == "--Ly" && has_value) {
+        config.Ly = toDouble(opt, args[++i]);
+    } else if (opt == "--thickness" && has_value) {
+        config.thickness = toDouble(opt, args[++i]);
+    } else if (opt == "--nx" && has_value) {
+        config.nx = toInt(opt, args[++i]);
+    } else if (opt == "--ny" && has_value) {
+        config.ny = toInt(opt, args[++i]);
+    } else if (opt == "--dt" && has_value) {
+        config.dt = toDouble(opt, args[++i]);
+    } else if (opt == "--t_end" && has_value) {
+        config.t_end = toDouble(opt, args[++i]);
+    } else if (opt == "--T0" && has_value) {
+        config.T0 = toDouble(opt, args[++i]);
+    }
+    // Material 1 properties
+    else if (opt == "--mat1_k" && has_value) {
+        config.mat_1_k = toDouble(opt, args[++i]);
+    } else if (opt == "--mat1_cp" && has_value) {
+        config.mat_1_cp = toDouble(opt, args[++i]);
+    } else if (opt == "--mat1_rho" && has_value) {
+        config.mat_1_rho = toDouble(opt, args[++i]);
+    } else if (opt == "--mat1_Tmelt" && has_value) {
+        config.mat_1_T_melt = toDouble(opt, args[++i]);
+    } else if (opt == "--mat1_Tcrit" && has_value) {
+        config.mat_1_T_crit = toDouble(opt, args[++i]);
+    }
+    // Material 2 properties
+    else if (opt == "--mat2_k" && has_value) {
+        config.mat_2_k = toDouble(opt, args[++i]);
+    } else if (opt == "--mat2_cp" && has_value) {
+        config.mat_2_cp = toDouble(opt, args[++i]);
+    } else if (opt == "--mat2_rho" && has_value) {
+        config.mat_2_rho = toDouble(opt, args[++i]);
+    } else if (opt == "--mat2_Tmelt" && has_value) {
+        config.mat_2_T_melt = toDouble(opt, args[++i]);
+    } else if (opt == "--mat2_Tcrit" && has_value) {
+        config.mat_2_T_crit = toDouble(opt, args[++i]);
+    }
+    // Video options
+    else if (opt == "--save_video") {
+        config.save_video_frames = true;
+    } else if (opt == "--video_fps" && has_value) {
+        config.video_frames_per_second = toInt(opt, args[++i]);
+    }
+    // Checkpoint options
+    else if (opt == "--checkpoint_interval" && has_value) {
+        config.checkpoint_interval = toInt(opt, args[++i]);
+    } else if (opt == "--checkpoint_file" && has_value) {
+        config.checkpoint_file = args[++i];
+    } else if (opt == "--restart" && has_value) {
+        config.restart_file = args[++i];
+    }
+    // Output options
+    else if (opt == "--output_dir" && has_value) {
+        config.output_dir = args[++i];
+    } else if (opt == "--probes" && has_value) {
+        config.probes = readProbeFile(args[++i]);
+    } else if (opt == "--path" && has_value) {
+        config.path = loadPathFile(args[++i]);
+    } else if (opt == "--sources" && has_value) {
+        config.sources = loadSourcesFile(args[++i]);
+    } else if (opt == "--history_chunk" && has_value) {
+        config.history_chunk_rows = toInt(opt, args[++i]);
+    } else if (opt == "--telemetry" && has_value) {
+        config.telemetry_path = args[++i];
+    } else if (opt == "--telemetry_hz" && has_value) {
+        config.telemetry_hz = toDouble(opt, args[++i]);
+    }
+    // Result cache
+    else if (opt == "--cache") {
+        config.use_cache = true;
+    } else if (opt == "--no-cache") {
+        config.use_cache = false;
+    } else if (opt == "--cache_dir" && has_value) {
+        config.cache_dir = args[++i];
+    } else if (opt == "--cache_max_mb" && has_value) {
+        config.cache_max_mb = toDouble(opt, args[++i]);
+    } else {
+        return false;
+    }
+
+    return true;
+}
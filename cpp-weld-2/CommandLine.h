@@ -0,0 +1,20 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <vector>
+#include <string>
+
+#include "WeldingSimulation.h"
+
+// Apply the configuration option at args[i] to config, advancing i past any
+// value it consumes. Returns false if args[i] is not a configuration option
+// (or its value is missing). Throws std::invalid_argument for bad values.
+//
+// Shared by the command line and batch files so both accept the same options.
+bool applyConfigOption(const std::vector<std::string>& args, size_t& i,
+                       SimulationConfig& config);
+
+// Split a line into whitespace-separated tokens
+std::vector<std::string> tokenize(const std::string& line);
+
+#endif // COMMAND_LINE_H
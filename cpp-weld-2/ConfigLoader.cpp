@@ -0,0 +1,558 @@
+#include "ConfigLoader.h"
+#include "HeatSource.h"
+#include <fstream>
+#include <cmath>
+#include <stdexcept>
+
+double requireNumber(const JsonValue& v, const std::string& where) {
+    if (!v.isNumber()) {
+        throw std::runtime_error(where + ": expected a number");
+    }
+    return v.number;
+}
+
+namespace {
+
+// One JSON key bound to one SimulationConfig member
+struct ConfigField {
+    const char* key;
+    double SimulationConfig::* number = nullptr;
+    int SimulationConfig::* integer = nullptr;
+    bool SimulationConfig::* flag = nullptr;
+    std::string SimulationConfig::* text = nullptr;
+};
+
+ConfigField field(const char* key, double SimulationConfig::* m) { ConfigField f{key}; f.number = m; return f; }
+ConfigField field(const char* key, int SimulationConfig::* m) { ConfigField f{key}; f.integer = m; return f; }
+ConfigField field(const char* key, bool SimulationConfig::* m) { ConfigField f{key}; f.flag = m; return f; }
+ConfigField field(const char* key, std::string SimulationConfig::* m) { ConfigField f{key}; f.text = m; return f; }
+
+struct ConfigSection {
+    const char* name;
+    std::vector<ConfigField> fields;
+};
+
+const std::vector<ConfigSection>& configSections() {
+    using C = SimulationConfig;
+    static const std::vector<ConfigSection> sections = {
+        {"simulation_parameters", {
+            field("Lx", &C::Lx), field("Ly", &C::Ly), field("thickness", &C::thickness),
+            field("nx", &C::nx), field("ny", &C::ny),
+            field("V", &C::V), field("I", &C::I), field("eta", &C::eta),
+            field("v_weld", &C::v_weld), field("x_start", &C::x_start), field("y_arc", &C::y_arc),
+            field("a", &C::a), field("b", &C::b), field("cf", &C::cf), field("cr", &C::cr),
+            field("ff", &C::ff), field("fr", &C::fr),
+            field("Q_beam", &C::Q_beam), field("R_beam", &C::R_beam), field("H_beam", &C::H_beam),
+            field("erw_current_density", &C::erw_current_density), field("erw_sigma_e", &C::erw_sigma_e),
+            field("erw_contact_width", &C::erw_contact_width),
+            field("erw_contact_resistance", &C::erw_contact_resistance),
+            field("erw_melt_factor", &C::erw_melt_factor),
+            field("weld_direction", &C::weld_direction),
+            field("T0", &C::T0), field("h_conv", &C::h_conv), field("dt", &C::dt), field("theta", &C::theta),
+            field("constant_properties", &C::constant_properties),
+            field("t_end", &C::t_end),
+            field("T_t85_high", &C::T_t85_high), field("T_t85_low", &C::T_t85_low),
+            field("weld_process", &C::weld_process), field("use_gas", &C::use_gas),
+            field("snapshot_time", &C::snapshot_time),
+        }},
+        {"material_1", {
+            field("name", &C::mat_1_name), field("rho", &C::mat_1_rho), field("cp", &C::mat_1_cp),
+            field("k", &C::mat_1_k), field("T_melt", &C::mat_1_T_melt), field("T_crit", &C::mat_1_T_crit),
+        }},
+        {"material_2", {
+            field("name", &C::mat_2_name), field("rho", &C::mat_2_rho), field("cp", &C::mat_2_cp),
+            field("k", &C::mat_2_k), field("T_melt", &C::mat_2_T_melt), field("T_crit", &C::mat_2_T_crit),
+        }},
+        {"output", {
+            field("output_dir", &C::output_dir),
+            field("save_video_frames", &C::save_video_frames),
+            field("video_frames_per_second", &C::video_frames_per_second),
+            field("history_chunk_rows", &C::history_chunk_rows),
+            field("telemetry_path", &C::telemetry_path),
+            field("telemetry_hz", &C::telemetry_hz),
+            field("checkpoint_interval", &C::checkpoint_interval),
+            field("checkpoint_file", &C::checkpoint_file),
+            field("restart_file", &C::restart_file),
+        }},
+        {"cache", {
+            field("use_cache", &C::use_cache),
+            field("cache_dir", &C::cache_dir),
+            field("cache_max_mb", &C::cache_max_mb),
+        }},
+    };
+    return sections;
+}
+
+int integerValue(const JsonValue& v, const std::string& where) {
+    double d = requireNumber(v, where);
+    if (d != std::floor(d) || std::fabs(d) > 2147483647.0) {
+        throw std::runtime_error(where + ": expected an integer");
+    }
+    return static_cast<int>(d);
+}
+
+void applyField(const ConfigField& f, const JsonValue& v, SimulationConfig& config,
+                const std::string& where) {
+    if (f.number) {
+        config.*f.number = requireNumber(v, where);
+    } else if (f.integer) {
+        config.*f.integer = integerValue(v, where);
+    } else if (f.flag) {
+        if (!v.isBool()) {
+            throw std::runtime_error(where + ": expected true or false");
+        }
+        config.*f.flag = v.boolean;
+    } else {
+        if (!v.isString()) {
+            throw std::runtime_error(where + ": expected a string");
+        }
+        config.*f.text = v.string;
+    }
+}
+
+JsonValue fieldValue(const ConfigField& f, const SimulationConfig& config) {
+    if (f.number) {
+        return JsonValue::makeNumber(config.*f.number);
+    } else if (f.integer) {
+        return JsonValue::makeNumber(config.*f.integer);
+    } else if (f.flag) {
+        return JsonValue::makeBool(config.*f.flag);
+    }
+    return JsonValue::makeString(config.*f.text);
+}
+
+std::vector<ProbeSpec> readProbes(const JsonValue& v) {
+    if (!v.isArray()) {
+        throw std::runtime_error("probes: expected an array");
+    }
+
+    std::vector<ProbeSpec> probes;
+    for (size_t k = 0; k < v.array.size(); ++k) {
+        const JsonValue& item = v.array[k];
+        const std::string where = "probes[" + std::to_string(k) + "]";
+        if (!item.isObject()) {
+            throw std::runtime_error(where + ": expected an object");
+        }
+
+        ProbeSpec probe;
+        probe.name = "p" + std::to_string(k + 1);
+        bool has_x = false, has_y = false;
+        for (const auto& member : item.object) {
+            const std::string key = where + "." + member.first;
+            if (member.first == "name") {
+                if (!member.second.isString()) {
+                    throw std::runtime_error(key + ": expected a string");
+                }
+                probe.name = member.second.string;
+            } else if (member.first == "x") {
+                probe.x = requireNumber(member.second, key);
+                has_x = true;
+            } else if (member.first == "y") {
+                probe.y = requireNumber(member.second, key);
+                has_y = true;
+            } else if (member.first == "interval") {
+                probe.interval = integerValue(member.second, key);
+                if (probe.interval < 1) {
+                    throw std::runtime_error(key + ": must be at least 1");
+                }
+            } else {
+                throw std::runtime_error("unknown key '" + key + "'");
+            }
+        }
+        if (!has_x || !has_y) {
+            throw std::runtime_error(where + ": x and y are required");
+        }
+        probes.push_back(probe);
+    }
+    return probes;
+}
+
+// Number or [start, end] pair
+void readRamp(const JsonValue& v, const std::string& where, double& start, double& end) {
+    if (v.isArray()) {
+        if (v.array.size() != 2) {
+            throw std::runtime_error(where + ": expected a number or [start, end]");
+        }
+        start = requireNumber(v.array[0], where + "[0]");
+        end = requireNumber(v.array[1], where + "[1]");
+    } else {
+        start = end = requireNumber(v, where);
+    }
+}
+
+// [x, y] point
+void readPoint(const JsonValue& v, const std::string& where, double& x, double& y) {
+    if (!v.isArray() || v.array.size() != 2) {
+        throw std::runtime_error(where + ": expected [x, y]");
+    }
+    x = requireNumber(v.array[0], where + "[0]");
+    y = requireNumber(v.array[1], where + "[1]");
+}
+
+PathSegment readSegment(const JsonValue& item, const std::string& where) {
+    if (!item.isObject()) {
+        throw std::runtime_error(where + ": expected an object");
+    }
+
+    PathSegment segment;
+    bool has_end = false, has_sweep = false;
+    for (const auto& member : item.object) {
+        const std::string key = where + "." + member.first;
+        if (member.first == "line" || member.first == "arc") {
+            if (has_end) {
+                throw std::runtime_error(key + ": a segment is either a line or an arc");
+            }
+            segment.kind = (member.first == "arc") ? PathSegment::Kind::Arc : PathSegment::Kind::Line;
+            readPoint(member.second, key, segment.x, segment.y);
+            has_end = true;
+        } else if (member.first == "sweep") {
+            segment.sweep = requireNumber(member.second, key);
+            has_sweep = true;
+        } else if (member.first == "speed") {
+            readRamp(member.second, key, segment.speed_start, segment.speed_end);
+            if (!(segment.speed_start > 0.0 && segment.speed_end > 0.0)) {
+                throw std::runtime_error(key + ": must be positive");
+            }
+        } else if (member.first == "power") {
+            readRamp(member.second, key, segment.power_start, segment.power_end);
+        } else {
+            throw std::runtime_error("unknown key '" + key + "'");
+        }
+    }
+    if (!has_end) {
+        throw std::runtime_error(where + ": \"line\": [x, y] or \"arc\": [cx, cy] is required");
+    }
+    if ((segment.kind == PathSegment::Kind::Arc) != has_sweep) {
+        throw std::runtime_error(where + ": \"sweep\" is required for arcs and only allowed for them");
+    }
+    return segment;
+}
+
+TorchPathSpec readPath(const JsonValue& v, const std::string& where = "path") {
+    if (!v.isObject()) {
+        throw std::runtime_error(where + ": expected an object");
+    }
+
+    TorchPathSpec path;
+    for (const auto& member : v.object) {
+        const std::string key = where + "." + member.first;
+        if (member.first == "start") {
+            readPoint(member.second, key, path.x0, path.y0);
+        } else if (member.first == "segments") {
+            if (!member.second.isArray()) {
+                throw std::runtime_error(key + ": expected an array");
+            }
+            for (size_t k = 0; k < member.second.array.size(); ++k) {
+                path.segments.push_back(readSegment(member.second.array[k], key + "[" + std::to_string(k) + "]"));
+            }
+        } else if (member.first == "weave") {
+            if (!member.second.isObject()) {
+                throw std::runtime_error(key + ": expected an object");
+            }
+            for (const auto& w : member.second.object) {
+                const std::string weave_key = key + "." + w.first;
+                if (w.first == "amplitude") {
+                    path.weave_amplitude = requireNumber(w.second, weave_key);
+                } else if (w.first == "frequency") {
+                    path.weave_frequency = requireNumber(w.second, weave_key);
+                } else {
+                    throw std::runtime_error("unknown key '" + weave_key + "'");
+                }
+            }
+        } else {
+            throw std::runtime_error("unknown key '" + key + "'");
+        }
+    }
+    return path;
+}
+
+JsonValue rampValue(double start, double end) {
+    if (start == end) {
+        return JsonValue::makeNumber(start);
+    }
+    JsonValue ramp = JsonValue::makeArray();
+    ramp.array.push_back(JsonValue::makeNumber(start));
+    ramp.array.push_back(JsonValue::makeNumber(end));
+    return ramp;
+}
+
+JsonValue pointValue(double x, double y) {
+    JsonValue point = JsonValue::makeArray();
+    point.array.push_back(JsonValue::makeNumber(x));
+    point.array.push_back(JsonValue::makeNumber(y));
+    return point;
+}
+
+JsonValue pathToJson(const TorchPathSpec& path) {
+    JsonValue root = JsonValue::makeObject();
+    if (!std::isnan(path.x0) && !std::isnan(path.y0)) {
+        root.set("start", pointValue(path.x0, path.y0));
+    }
+    JsonValue& segments = root.set("segments", JsonValue::makeArray());
+    for (const auto& s : path.segments) {
+        JsonValue segment = JsonValue::makeObject();
+        if (s.kind == PathSegment::Kind::Arc) {
+            segment.set("arc", pointValue(s.x, s.y));
+            segment.set("sweep", JsonValue::makeNumber(s.sweep));
+        } else {
+            segment.set("line", pointValue(s.x, s.y));
+        }
+        if (s.speed_start > 0.0) {
+            // Otherwise v_weld
+            segment.set("speed", rampValue(s.speed_start, s.speed_end > 0.0 ? s.speed_end : s.speed_start));
+        }
+        segment.set("power", rampValue(s.power_start, s.power_end));
+        segments.array.push_back(segment);
+    }
+    JsonValue& weave = root.set("weave", JsonValue::makeObject());
+    weave.set("amplitude", JsonValue::makeNumber(path.weave_amplitude));
+    weave.set("frequency", JsonValue::makeNumber(path.weave_frequency));
+    return root;
+}
+
+std::vector<SourceSpec> readSources(const JsonValue& v) {
+    if (!v.isArray()) {
+        throw std::runtime_error("sources: expected an array");
+    }
+
+    std::vector<SourceSpec> sources;
+    for (size_t k = 0; k < v.array.size(); ++k) {
+        const JsonValue& item = v.array[k];
+        const std::string where = "sources[" + std::to_string(k) + "]";
+        if (!item.isObject()) {
+            throw std::runtime_error(where + ": expected an object");
+        }
+
+        SourceSpec source;
+        for (const auto& member : item.object) {
+            const std::string key = where + "." + member.first;
+            const SourceField* f = nullptr;
+            for (const auto& candidate : sourceFields()) {
+                if (member.first == candidate.key) {
+                    f = &candidate;
+                }
+            }
+            if (f) {
+                source.*f->source = requireNumber(member.second, key);
+            } else if (member.first == "weld_process") {
+                if (!member.second.isString() || !isWeldProcess(member.second.string)) {
+                    throw std::runtime_error(key + ": use TIG, Electrode, Custom, EBW, LBW, PAW, SAW or ERW");
+                }
+                source.weld_process = member.second.string;
+            } else if (member.first == "delay") {
+                source.delay = requireNumber(member.second, key);
+                if (source.delay < 0.0) {
+                    throw std::runtime_error(key + ": must not be negative");
+                }
+            } else if (member.first == "path") {
+                source.path = readPath(member.second, key);
+            } else {
+                throw std::runtime_error("unknown key '" + key + "'");
+            }
+        }
+        sources.push_back(source);
+    }
+    return sources;
+}
+
+JsonValue sourcesToJson(const std::vector<SourceSpec>& sources) {
+    JsonValue array = JsonValue::makeArray();
+    for (const auto& s : sources) {
+        JsonValue source = JsonValue::makeObject();
+        if (!s.weld_process.empty()) {
+            source.set("weld_process", JsonValue::makeString(s.weld_process));
+        }
+        for (const auto& f : sourceFields()) {
+            if (!std::isnan(s.*f.source)) {
+                source.set(f.key, JsonValue::makeNumber(s.*f.source));
+            }
+        }
+        if (s.delay != 0.0) {
+            source.set("delay", JsonValue::makeNumber(s.delay));
+        }
+        if (!s.path.empty()) {
+            source.set("path", pathToJson(s.path));
+        }
+        array.array.push_back(source);
+    }
+    return array;
+}
+
+} // namespace
+
+void applyConfigJson(const JsonValue& root, SimulationConfig& config) {
+    if (!root.isObject()) {
+        throw std::runtime_error("configuration must be a JSON object");
+    }
+
+    // Apply to a copy so a failed load leaves config untouched
+    SimulationConfig updated = config;
+
+    for (const auto& member : root.object) {
+        if (member.first == "probes") {
+            updated.probes = readProbes(member.second);
+            continue;
+        }
+        if (member.first == "path") {
+            updated.path = readPath(member.second);
+            continue;
+        }
+        if (member.first == "sources") {
+            updated.sources = readSources(member.second);
+            continue;
+        }
+
+        const ConfigSection* section = nullptr;
+        for (const auto& s : configSections()) {
+            if (member.first == s.name) {
+                section = &s;
+            }
+        }
+        if (!section) {
+            throw std::runtime_error("unknown section '" + member.first + "'");
+        }
+        if (!member.second.isObject()) {
+            throw std::runtime_error(member.first + ": expected an object");
+        }
+
+        for (const auto& entry : member.second.object) {
+            const std::string where = member.first + "." + entry.first;
+            const ConfigField* f = nullptr;
+            for (const auto& candidate : section->fields) {
+                if (entry.first == candidate.key) {
+                    f = &candidate;
+                }
+            }
+            if (!f) {
+                throw std::runtime_error("unknown key '" + where + "'");
+            }
+            applyField(*f, entry.second, updated, where);
+        }
+    }
+
+    if (!isWeldProcess(updated.weld_process)) {
+        throw std::runtime_error("simulation_parameters.weld_process: use TIG, Electrode, Custom, "
+                                 "EBW, LBW, PAW, SAW or ERW");
+    }
+    if (updated.weld_direction != "x" && updated.weld_direction != "y") {
+        throw std::runtime_error("simulation_parameters.weld_direction: use 'x' or 'y'");
+    }
+
+    config = updated;
+}
+
+TorchPathSpec loadPathFile(const std::string& filename) {
+    JsonValue root = readJsonFile(filename);
+    try {
+        return readPath(root);
+    } catch (const std::exception& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+}
+
+std::vector<SourceSpec> loadSourcesFile(const std::string& filename) {
+    JsonValue root = readJsonFile(filename);
+    try {
+        return readSources(root);
+    } catch (const std::exception& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+}
+
+void loadConfigFile(const std::string& filename, SimulationConfig& config) {
+    JsonValue root = readJsonFile(filename);
+    try {
+        applyConfigJson(root, config);
+    } catch (const std::exception& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+}
+
+namespace {
+
+// Field named by a setConfigValue() name; throws for unknown or non-numeric keys
+const ConfigField& numericField(const std::string& name) {
+    const size_t dot = name.find('.');
+    const std::string section_name = (dot == std::string::npos) ? "simulation_parameters" : name.substr(0, dot);
+    const std::string key = (dot == std::string::npos) ? name : name.substr(dot + 1);
+
+    for (const auto& section : configSections()) {
+        if (section_name != section.name) {
+            continue;
+        }
+        for (const auto& f : section.fields) {
+            if (key != f.key) {
+                continue;
+            }
+            if (!f.number && !f.integer) {
+                throw std::runtime_error("parameter '" + name + "' is not numeric");
+            }
+            return f;
+        }
+    }
+    throw std::runtime_error("unknown parameter '" + name + "'");
+}
+
+} // namespace
+
+void setConfigValue(SimulationConfig& config, const std::string& name, double value) {
+    const ConfigField& f = numericField(name);
+    if (f.number) {
+        config.*f.number = value;
+    } else {
+        config.*f.integer = static_cast<int>(std::lround(value));
+    }
+}
+
+double getConfigValue(const SimulationConfig& config, const std::string& name) {
+    const ConfigField& f = numericField(name);
+    return f.number ? config.*f.number : config.*f.integer;
+}
+
+void validateParameterName(const SimulationConfig& base, const std::string& name) {
+    numericField(name);
+    if (name == "eta" && (base.weld_process == "TIG" || base.weld_process == "Electrode")) {
+        throw std::runtime_error("parameters.eta: the " + base.weld_process +
+                                 " preset fixes eta; use weld_process \"Custom\"");
+    }
+}
+
+JsonValue configToJson(const SimulationConfig& config) {
+    JsonValue root = JsonValue::makeObject();
+    for (const auto& section : configSections()) {
+        JsonValue& obj = root.set(section.name, JsonValue::makeObject());
+        for (const auto& f : section.fields) {
+            obj.set(f.key, fieldValue(f, config));
+        }
+    }
+
+    JsonValue& probes = root.set("probes", JsonValue::makeArray());
+    for (const auto& p : config.probes) {
+        JsonValue probe = JsonValue::makeObject();
+        probe.set("name", JsonValue::makeString(p.name));
+        probe.set("x", JsonValue::makeNumber(p.x));
+        probe.set("y", JsonValue::makeNumber(p.y));
+        probe.set("interval", JsonValue::makeNumber(p.interval));
+        probes.array.push_back(probe);
+    }
+
+    if (!config.path.empty()) {
+        root.set("path", pathToJson(config.path));
+    }
+    if (!config.sources.empty()) {
+        root.set("sources", sourcesToJson(config.sources));
+    }
+    return root;
+}
+
+void saveConfigFile(const std::string& filename, const SimulationConfig& config) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    writeJson(file, configToJson(config));
+    file << std::endl;
+    if (!file) {
+        throw std::runtime_error("Failed to write " + filename);
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef CONFIG_LOADER_H
+#define CONFIG_LOADER_H
+
+#include <string>
+
+#include "Json.h"
+#include "WeldingSimulation.h"
+
+// JSON configuration files, using the schema of the Python simulators'
+// config.json:
+//
+//   {
+//     "simulation_parameters": { "Lx": 0.15, "nx": 151, "V": 25.0, ... },
+//     "material_1": { "name": ..., "rho": ..., "cp": ..., "k": ...,
+//                     "T_melt": ..., "T_crit": ... },
+//     "material_2": { ... },
+//     "output":     { "output_dir": ..., "history_chunk_rows": ..., ... },
+//     "cache":      { "use_cache": false, "cache_dir": ..., "cache_max_mb": ... },
+//     "probes":     [ { "name": "pt1", "x": 0.05, "y": 0.0, "interval": 1 } ],
+//     "path":       { "start": [0.02, 0.0],
+//                     "segments": [ { "line": [0.07, 0.0], "speed": 0.006 },
+//                                   { "arc": [0.07, 0.02], "sweep": 90,
+//                                     "speed": [0.006, 0.004], "power": [1.0, 0.8] } ],
+//                     "weave": { "amplitude": 0.0015, "frequency": 2.0 } },
+//     "sources":    [ { "weld_process": "SAW", "V": 32, "I": 700 },
+//                     { "weld_process": "SAW", "V": 36, "I": 500, "delay": 3.0 } ]
+//   }
+//
+// simulation_parameters keys are the SimulationConfig member names. "output",
+// "cache", "probes" and "path" are C++ extensions. A path segment is a
+// "line" to an end point or an "arc" about a centre through "sweep" degrees
+// (positive counter-clockwise). "speed" (m/s, default v_weld) and "power"
+// (fraction of the source power, default 1) are a number or a linear
+// [start, end] ramp along the segment. "sources" lists simultaneous heat
+// sources; each takes weld_process, V, I, eta, a, b, ff, fr, Q_beam, R_beam,
+// H_beam and path from simulation_parameters unless it sets them, and
+// starts its path "delay" seconds into the run. Every section and key is optional;
+// keys that are present override the values already in config. Unknown keys
+// are errors, so typos do not silently fall back to defaults.
+
+// v as a number. Throws std::runtime_error "<where>: expected a number" otherwise.
+double requireNumber(const JsonValue& v, const std::string& where);
+
+// Apply a parsed document to config. Throws std::runtime_error naming the
+// offending key on unknown keys, wrong types or invalid values.
+void applyConfigJson(const JsonValue& root, SimulationConfig& config);
+
+// Read filename and apply it to config (errors are prefixed with the file name)
+void loadConfigFile(const std::string& filename, SimulationConfig& config);
+
+// Read a file holding just a "path" object (errors are prefixed with the file name)
+TorchPathSpec loadPathFile(const std::string& filename);
+
+// Read a file holding just a "sources" array (errors are prefixed with the file name)
+std::vector<SourceSpec> loadSourcesFile(const std::string& filename);
+
+// Set one numeric parameter by its JSON name: a simulation_parameters key
+// ("I", "v_weld", "a", ...) or "<section>.<key>" ("material_2.k"). Integer
+// fields are rounded. Throws std::runtime_error for unknown or non-numeric keys.
+void setConfigValue(SimulationConfig& config, const std::string& name, double value);
+
+// Current value of a parameter named as for setConfigValue()
+double getConfigValue(const SimulationConfig& config, const std::string& name);
+
+// Check that name can be varied by a sweep or a calibration: a numeric
+// setConfigValue() name, and not eta while base uses a preset (TIG,
+// Electrode) that fixes it. Throws std::runtime_error otherwise.
+void validateParameterName(const SimulationConfig& base, const std::string& name);
+
+// Complete document for config; loading it reproduces config exactly
+JsonValue configToJson(const SimulationConfig& config);
+
+// Write configToJson(config) to filename. Throws std::runtime_error on I/O errors.
+void saveConfigFile(const std::string& filename, const SimulationConfig& config);
+
+#endif // CONFIG_LOADER_H
@@ -0,0 +1,366 @@
+#include "EnsembleSimulation.h"
+#include "HeatSource.h"
+#include "SimdMath.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <omp.h>
+
+bool EnsembleSimulation::compatible(const SimulationConfig& a, const SimulationConfig& b) {
+    return a.nx == b.nx && a.ny == b.ny && a.Lx == b.Lx && a.Ly == b.Ly &&
+           a.dt == b.dt && a.T0 == b.T0;
+}
+
+EnsembleSimulation::EnsembleSimulation(const std::vector<SimulationConfig>& variants,
+                                       std::shared_ptr<const SimulationGrid> grid,
+                                       std::ostream* log)
+    : configs_(variants),
+      log_(log ? *log : null_log_) {
+
+    if (configs_.empty()) {
+        throw std::invalid_argument("Ensemble needs at least one variant");
+    }
+    for (const auto& c : configs_) {
+        if (!compatible(c, configs_[0])) {
+            throw std::invalid_argument("Ensemble variants must share nx, ny, Lx, Ly, dt and T0");
+        }
+        if (c.weld_direction != "x" && c.weld_direction != "y") {
+            throw std::invalid_argument("Invalid weld_direction '" + c.weld_direction + "'. Use 'x' or 'y'.");
+        }
+        if (!c.path.empty()) {
+            throw std::invalid_argument("Ensembles support straight paths only; run torch path scenarios without --ensemble");
+        }
+        if (!c.sources.empty()) {
+            throw std::invalid_argument("Ensembles support a single heat source; run multi-source scenarios without --ensemble");
+        }
+        if (!isGoldakProcess(c.weld_process)) {
+            throw std::invalid_argument("Ensembles support the Goldak arc processes (TIG, Electrode, Custom); run " +
+                                        c.weld_process + " scenarios without --ensemble");
+        }
+    }
+
+    const SimulationConfig& base = configs_[0];
+    grid_ = (grid && grid->matches(base)) ? std::move(grid) : makeGrid(base);
+    nx_ = base.nx;
+    ny_ = base.ny;
+    N_ = nx_ * ny_;
+    M_ = static_cast<int>(configs_.size());
+    dx_ = grid_->dx;
+    dy_ = grid_->dy;
+    dt_ = base.dt;
+    T0_ = base.T0;
+    midpoint_ = base.Lx / 2.0;
+
+    // Per-lane constants
+    auto& L = lanes_;
+    nt_max_ = 0;
+    for (auto& c : configs_) {
+        c.eta = processEfficiency(c);
+        const double Q = c.eta * c.V * c.I;
+
+        L.Q_total.push_back(Q);
+        L.coeff_f.push_back((c.ff * Q) / (c.a * c.b * M_PI));
+        L.coeff_r.push_back((c.fr * Q) / (c.a * c.b * M_PI));
+        L.a_sq.push_back(c.a * c.a);
+        L.b_sq.push_back(c.b * c.b);
+        L.reach_x.push_back(4.0 * c.a);  // Same reach as makeGoldak()
+        L.reach_y.push_back(4.0 * c.b);
+        L.thickness.push_back(c.thickness);
+
+        L.rho[0].push_back(c.mat_1_rho);     L.rho[1].push_back(c.mat_2_rho);
+        L.cp[0].push_back(c.mat_1_cp);       L.cp[1].push_back(c.mat_2_cp);
+        L.k[0].push_back(c.mat_1_k);         L.k[1].push_back(c.mat_2_k);
+        L.T_melt[0].push_back(c.mat_1_T_melt); L.T_melt[1].push_back(c.mat_2_T_melt);
+        L.T_crit[0].push_back(c.mat_1_T_crit); L.T_crit[1].push_back(c.mat_2_T_crit);
+        L.constant.push_back(c.constant_properties ? 1.0 : 0.0);
+
+        paths_.emplace_back(c);
+        L.nt.push_back(timeStepCount(c));
+        nt_max_ = std::max(nt_max_, L.nt.back());
+    }
+
+    const size_t cells = static_cast<size_t>(N_) * M_;
+    T_.assign(cells, T0_);
+    T_new_.assign(cells, T0_);
+    T_max_.assign(cells, T0_);
+    Qvol_.assign(cells, 0.0);
+    x_arc_.assign(M_, 0.0);
+    y_arc_.assign(M_, 0.0);
+    heating_.assign(M_, 0.0);
+    active_.assign(M_, 1.0);
+    win_i0_.assign(M_, 0.0);
+    win_i1_.assign(M_, -1.0);
+    win_j0_.assign(M_, 0.0);
+    win_j1_.assign(M_, -1.0);
+
+    log_ << "Ensemble: " << M_ << " variants on " << nx_ << "x" << ny_
+         << ", up to " << nt_max_ << " time steps" << std::endl;
+}
+
+void EnsembleSimulation::computeSource(double t) {
+    const int M = M_;
+    const auto& L = lanes_;
+
+    // Only the cells written last step are non-zero
+    const CellWindow& last = source_box_;
+    for (int j = last.j0; j <= last.j1; ++j) {
+        const size_t row = static_cast<size_t>(j) * nx_;
+        std::fill(Qvol_.begin() + (row + last.i0) * M, Qvol_.begin() + (row + last.i1 + 1) * M, 0.0);
+    }
+
+    const double x0 = grid_->x[0];
+    const double y0 = grid_->y[0];
+    CellWindow box;
+    box.i0 = nx_; box.i1 = -1; box.j0 = ny_; box.j1 = -1;
+    for (int m = 0; m < M; ++m) {
+        // TorchPath rather than arcPosition(): the same compiled arithmetic
+        // as the single run, so an arc landing on a node picks the same
+        // Goldak half
+        const TorchState state = paths_[m].at(t);
+        x_arc_[m] = state.x;
+        y_arc_[m] = state.y;
+        const bool heating = active_[m] != 0.0 && state.on;
+        heating_[m] = heating ? 1.0 : 0.0;
+
+        // Same window as WeldingSimulation::sourceWindow(), so each lane
+        // matches its single run
+        win_i0_[m] = std::max(0, static_cast<int>(std::floor((x_arc_[m] - L.reach_x[m] - x0) / dx_)));
+        win_i1_[m] = std::min(nx_ - 1, static_cast<int>(std::ceil((x_arc_[m] + L.reach_x[m] - x0) / dx_)));
+        win_j0_[m] = std::max(0, static_cast<int>(std::floor((y_arc_[m] - L.reach_y[m] - y0) / dy_)));
+        win_j1_[m] = std::min(ny_ - 1, static_cast<int>(std::ceil((y_arc_[m] + L.reach_y[m] - y0) / dy_)));
+        if (heating) {
+            box.i0 = std::min(box.i0, static_cast<int>(win_i0_[m]));
+            box.i1 = std::max(box.i1, static_cast<int>(win_i1_[m]));
+            box.j0 = std::min(box.j0, static_cast<int>(win_j0_[m]));
+            box.j1 = std::max(box.j1, static_cast<int>(win_j1_[m]));
+        }
+    }
+
+    source_box_ = box;
+    if (box.empty()) {
+        return;
+    }
+
+    const int nx = nx_;
+    const double* x = grid_->x.data();
+    const double* y = grid_->y.data();
+    const double* x_arc = x_arc_.data();
+    const double* y_arc = y_arc_.data();
+    const double* coeff_f = L.coeff_f.data();
+    const double* coeff_r = L.coeff_r.data();
+    const double* a_sq = L.a_sq.data();
+    const double* b_sq = L.b_sq.data();
+    const double* thickness = L.thickness.data();
+    const double* heating = heating_.data();
+    const double* i0 = win_i0_.data();
+    const double* i1 = win_i1_.data();
+    const double* j0 = win_j0_.data();
+    const double* j1 = win_j1_.data();
+
+    // Goldak surface flux converted to volumetric, lanes innermost, over the
+    // union of the lanes' windows. The lane body is branch-free (selects,
+    // mask multiplies, inline exp) so it vectorizes; cells outside a lane's
+    // own window get zero, as in a single run.
+    #pragma omp parallel for
+    for (int j = box.j0; j <= box.j1; ++j) {
+        const double jd = j;
+        const double yc = y[j];
+        for (int i = box.i0; i <= box.i1; ++i) {
+            double* q = &Qvol_[(static_cast<size_t>(j) * nx + i) * M];
+            const double id = i;
+            const double xc = x[i];
+
+            #pragma omp simd
+            for (int m = 0; m < M; ++m) {
+                const double xi = xc - x_arc[m];
+                const double eta = yc - y_arc[m];
+                const double exp_arg = -xi * xi / a_sq[m] - eta * eta / b_sq[m];
+                const double coeff = (xi >= 0.0) ? coeff_f[m] : coeff_r[m];  // Front or rear quadrant coefficient
+                const double flux = coeff * simdExp(exp_arg) / thickness[m];
+                // & rather than &&: a short-circuit branch stops the loop vectorizing
+                const bool inside = (id >= i0[m]) & (id <= i1[m]) & (jd >= j0[m]) & (jd <= j1[m]);
+                q[m] = heating[m] * (inside ? flux : 0.0);
+            }
+        }
+    }
+}
+
+void EnsembleSimulation::solveTimeStep() {
+    const int M = M_;
+    const int nx = nx_;
+    const auto& L = lanes_;
+    const double dt = dt_;
+    const double T0 = T0_;
+    const double dx_sq = dx_ * dx_;
+    const double dy_sq = dy_ * dy_;
+    const double inv_sum = 1.0 / dx_sq + 1.0 / dy_sq;
+    const double T_MAX_REASONABLE = 5000.0;  // Same clamp as the single-run solver
+
+    const double* T = T_.data();
+    double* T_new = T_new_.data();
+    double* T_max = T_max_.data();
+    const double* Qvol = Qvol_.data();
+    const double* active = active_.data();
+
+    #pragma omp parallel for
+    for (int j = 0; j < ny_; ++j) {
+        for (int i = 0; i < nx; ++i) {
+            const size_t cell = static_cast<size_t>(j) * nx + i;
+            const size_t c = cell * M;
+
+            if (i == 0 || i == nx - 1 || j == 0 || j == ny_ - 1) {
+                for (int m = 0; m < M; ++m) {
+                    T_new[c + m] = T0;
+                }
+                continue;
+            }
+
+            // Material side is a property of the cell, shared by all lanes
+            const int side = (grid_->X[cell] < midpoint_) ? 0 : 1;
+            const double* k0 = L.k[side].data();
+            const double* cp0 = L.cp[side].data();
+            const double* rho0 = L.rho[side].data();
+            const double* Tm = L.T_melt[side].data();
+            const double* Tc = L.T_crit[side].data();
+            const double* constant = L.constant.data();
+
+            const size_t xm = c - M, xp = c + M;
+            const size_t ym = c - static_cast<size_t>(nx) * M;
+            const size_t yp = c + static_cast<size_t>(nx) * M;
+
+            #pragma omp simd
+            for (int m = 0; m < M; ++m) {
+                const double Tcell = T[c + m];
+
+                // Piecewise-linear properties (same model as Material), as
+                // selects between the three segments' factors; constant
+                // property lanes take the solid segment at every temperature
+                const double frac = (Tcell - Tc[m]) / (Tm[m] - Tc[m]);
+                // | rather than ||: a short-circuit branch stops the loop vectorizing
+                const bool solid = (Tcell < Tc[m]) | (constant[m] != 0.0);
+                const bool molten = Tcell >= Tm[m];
+                double f_k = 1.0 + frac * 0.1;
+                double f_cp = 1.0 + frac * 0.2;
+                double f_rho = 1.0 - frac * 0.05;
+                f_k = molten ? 1.1 : f_k;
+                f_cp = molten ? 1.2 : f_cp;
+                f_rho = molten ? 0.95 : f_rho;
+                f_k = solid ? 1.0 : f_k;
+                f_cp = solid ? 1.0 : f_cp;
+                f_rho = solid ? 1.0 : f_rho;
+                const double k = k0[m] * f_k;
+                const double cp = cp0[m] * f_cp;
+                const double rho = rho0[m] * f_rho;
+
+                double alpha = k / (rho * cp);
+                double d2T_dx2 = (T[xp + m] - 2.0 * Tcell + T[xm + m]) / dx_sq;
+                double d2T_dy2 = (T[yp + m] - 2.0 * Tcell + T[ym + m]) / dy_sq;
+                double heat_source = Qvol[c + m] / (rho * cp);
+
+                // Ternaries, not std::min/max: their reference results make GCC
+                // keep per-lane arrays in omp simd loops, which GCC 12 gets wrong
+                double max_dt_stable = 0.4 / (alpha * inv_sum);
+                double dt_effective = (max_dt_stable < dt) ? max_dt_stable : dt;
+
+                double value = Tcell + dt_effective * (alpha * (d2T_dx2 + d2T_dy2) + heat_source);
+                value = (T_MAX_REASONABLE < value) ? T_MAX_REASONABLE : value;
+                value = (value < T0) ? T0 : value;
+
+                // Finished lanes keep their final state
+                T_new[c + m] = (active[m] != 0.0) ? value : Tcell;
+            }
+        }
+    }
+
+    T_.swap(T_new_);
+
+    const size_t cells = static_cast<size_t>(N_) * M;
+    const double* T_cur = T_.data();
+    #pragma omp parallel for
+    for (size_t c = 0; c < cells; ++c) {
+        T_max[c] = std::max(T_max[c], T_cur[c]);
+    }
+}
+
+void EnsembleSimulation::run() {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    log_ << "Running ensemble..." << std::endl;
+
+    // Time accumulates exactly as in WeldingSimulation::run()
+    double t = 0.0;
+    for (int step = 1; step <= nt_max_; ++step) {
+        t += dt_;
+        for (int m = 0; m < M_; ++m) {
+            active_[m] = (step <= lanes_.nt[m]) ? 1.0 : 0.0;
+        }
+
+        computeSource(t);
+        solveTimeStep();
+
+        if (step % std::max(1, nt_max_ / 10) == 0 || step == nt_max_) {
+            log_ << "Progress: " << (100 * step / nt_max_) << "%" << std::endl;
+        }
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    log_ << "Ensemble completed in " << duration.count() / 1000.0 << "s ("
+         << duration.count() / 1000.0 / M_ << "s per variant)" << std::endl;
+}
+
+SimulationStatistics EnsembleSimulation::statistics(int m) const {
+    const auto& L = lanes_;
+    const double T_melt = (L.T_melt[0][m] + L.T_melt[1][m]) / 2.0;
+    const double T_crit = (L.T_crit[0][m] + L.T_crit[1][m]) / 2.0;
+
+    SimulationStatistics stats;
+    stats.T_peak = T0_;
+    size_t fusion = 0, haz = 0;
+    for (int cell = 0; cell < N_; ++cell) {
+        double Tm = T_max_[static_cast<size_t>(cell) * M_ + m];
+        stats.T_peak = std::max(stats.T_peak, Tm);
+        if (Tm >= T_melt) {
+            ++fusion;
+        } else if (Tm >= T_crit) {
+            ++haz;
+        }
+    }
+    stats.fusion_area = fusion * dx_ * dy_;
+    stats.HAZ_area = haz * dx_ * dy_;
+    return stats;
+}
+
+std::vector<double> EnsembleSimulation::lane(const std::vector<double>& field, int m) const {
+    std::vector<double> out(N_);
+    for (int cell = 0; cell < N_; ++cell) {
+        out[cell] = field[static_cast<size_t>(cell) * M_ + m];
+    }
+    return out;
+}
+
+void EnsembleSimulation::exportResults(int m) const {
+    std::string filename = configs_[m].output_dir + "/simulation_results.csv";
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return;
+    }
+
+    file << std::setprecision(6) << std::fixed;
+    file << "i,j,x,y,T_final,T_max" << std::endl;
+
+    for (int j = 0; j < ny_; ++j) {
+        for (int i = 0; i < nx_; ++i) {
+            size_t c = (static_cast<size_t>(j) * nx_ + i) * M_ + m;
+            file << i << "," << j << ","
+                 << grid_->x[i] << "," << grid_->y[j] << ","
+                 << T_[c] << "," << T_max_[c] << std::endl;
+        }
+    }
+
+    log_ << "Results exported to " << filename << std::endl;
+}
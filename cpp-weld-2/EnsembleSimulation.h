@@ -0,0 +1,97 @@
+#ifndef ENSEMBLE_SIMULATION_H
+#define ENSEMBLE_SIMULATION_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <ostream>
+#include <iostream>
+
+#include "WeldingSimulation.h"
+#include "TorchPath.h"
+
+// Advances M variants of the same plate in one stencil sweep.
+//
+// Fields are interleaved cell-major, variant-minor (T[cell * M + m]), so the
+// inner loop over variants reads contiguous memory and vectorizes across
+// SIMD lanes while each neighbour row is loaded once for all variants. The
+// lane bodies have no branches: finished and idle lanes are masked with
+// numeric masks, the material law is a chain of selects and the source uses
+// simdExp(). Each variant has its own power, speed, arc position, Goldak
+// axes, material constants and property law (constant_properties);
+// geometry, grid, time step and ambient temperature are shared.
+//
+// The update is the same explicit scheme as WeldingSimulation. Each lane
+// places its arc with TorchPath and cuts its source to the window of
+// WeldingSimulation::sourceWindow(), so each variant reproduces its single
+// run's T_final/T_max (the ensemble case of verify_welding checks this).
+// Probes, cooling metrics, melt pool tracking, checkpoints and video frames
+// are single-run features.
+class EnsembleSimulation {
+public:
+    // Throws std::invalid_argument if the variants do not share geometry,
+    // grid, dt and T0
+    EnsembleSimulation(const std::vector<SimulationConfig>& variants,
+                       std::shared_ptr<const SimulationGrid> grid = nullptr,
+                       std::ostream* log = &std::cout);
+
+    // Whether two configurations can share an ensemble
+    static bool compatible(const SimulationConfig& a, const SimulationConfig& b);
+
+    void run();
+
+    int size() const { return M_; }
+
+    // Statistics of variant m (cooling metrics are not tracked: -1 / 0)
+    SimulationStatistics statistics(int m) const;
+
+    // Final and peak temperature fields of variant m (row-major, like
+    // WeldingSimulation::temperature())
+    std::vector<double> temperature(int m) const { return lane(T_, m); }
+    std::vector<double> peakTemperature(int m) const { return lane(T_max_, m); }
+
+    // Write variant m's simulation_results.csv (i,j,x,y,T_final,T_max)
+    // to its config's output_dir
+    void exportResults(int m) const;
+
+private:
+    // Per-variant constants, stored struct-of-arrays so the lane loop vectorizes
+    struct LaneParams {
+        std::vector<double> Q_total;
+        std::vector<double> coeff_f, coeff_r, a_sq, b_sq;
+        std::vector<double> reach_x, reach_y;  // Source window half-widths (4a, 4b)
+        std::vector<double> thickness;
+        // Material 1 and 2 constants: [0] = mat_1, [1] = mat_2
+        std::vector<double> rho[2], cp[2], k[2], T_melt[2], T_crit[2];
+        std::vector<double> constant;  // 1.0: constant_properties, room-temperature values
+        std::vector<int> nt;
+    };
+
+    std::vector<SimulationConfig> configs_;
+    std::ostream null_log_{nullptr};
+    std::ostream& log_;
+
+    std::shared_ptr<const SimulationGrid> grid_;
+    int nx_, ny_, N_, M_;
+    double dx_, dy_, dt_, T0_, midpoint_;
+    int nt_max_;
+
+    LaneParams lanes_;
+
+    // Interleaved fields: index cell * M_ + m
+    std::vector<double> T_, T_new_, T_max_, Qvol_;
+    std::vector<TorchPath> paths_;       // Straight path per lane, as in a single run
+    std::vector<double> x_arc_, y_arc_;  // Current arc position per lane
+    // Lane masks (1.0 / 0.0), numeric so the lane loops blend instead of branch
+    std::vector<double> heating_;  // Arc still on the plate
+    std::vector<double> active_;   // Lane has steps left
+    // Source window per lane (cell indices, as doubles for the lane loop)
+    std::vector<double> win_i0_, win_i1_, win_j0_, win_j1_;
+    CellWindow source_box_;  // Union of last step's windows: the only non-zero Qvol cells
+
+    std::vector<double> lane(const std::vector<double>& field, int m) const;
+    void computeSource(double t);
+    void solveTimeStep();
+};
+
+#endif // ENSEMBLE_SIMULATION_H
@@ -0,0 +1,250 @@
+#include "HeatSource.h"
+#include "SimdMath.h"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Source shapes: policy classes giving Qvol (W/m³) at offset (dx, dy) from
+// the source centre. ShapedSource<Shape> runs them in one loop per step, so
+// the shape is inlined into the loop instead of called per cell. Shapes are
+// branch-free and use simdExp(), so the loops vectorize for every process.
+
+// Goldak double ellipsoid (surface form, spread over the thickness)
+struct GoldakShape {
+    double a_sq, b_sq, coeff_f, coeff_r, thickness;
+
+    double operator()(double xi, double eta) const {
+        const double exp_arg = -xi * xi / a_sq - eta * eta / b_sq;
+        const double coeff = (xi >= 0.0) ? coeff_f : coeff_r;  // Front or rear quadrant (a select)
+        return coeff * simdExp(exp_arg) / thickness;
+    }
+};
+
+// Axisymmetric Gaussian peak * exp(-r² inv_R_sq): EBW, LBW, PAW and ERW
+struct GaussianShape {
+    double peak, inv_R_sq;
+
+    double operator()(double dx, double dy) const {
+        return peak * simdExp(-(dx * dx + dy * dy) * inv_R_sq);
+    }
+};
+
+// Elliptical Gaussian peak * exp(-xi² inv_a_sq - eta² inv_b_sq): SAW
+struct EllipticShape {
+    double peak, inv_a_sq, inv_b_sq;
+
+    double operator()(double xi, double eta) const {
+        return peak * simdExp(-xi * xi * inv_a_sq - eta * eta * inv_b_sq);
+    }
+};
+
+template <class Shape>
+class ShapedSource : public HeatSource {
+public:
+    ShapedSource(const char* name, const Shape& shape, double power, double reach_x, double reach_y)
+        : name_(name), shape_(shape), power_(power), reach_x_(reach_x), reach_y_(reach_y) {}
+
+    const char* name() const override { return name_; }
+    double power() const override { return power_; }
+
+    void reach(double& reach_x, double& reach_y) const override {
+        reach_x = reach_x_;
+        reach_y = reach_y_;
+    }
+
+    void accumulate(const SimulationGrid& grid, double x_src, double y_src, double power,
+                    const CellWindow& window, double* Q) const override {
+        const Shape shape = shape_;  // Local copy: no aliasing with Q
+
+        // The meshgrid is a tensor product: x depends on i, y on j
+        const double* x = grid.x.data();
+        for (int j = window.j0; j <= window.j1; ++j) {
+            const double dy = grid.y[j] - y_src;
+            double* Q_row = Q + static_cast<size_t>(j) * grid.nx;
+
+            #pragma omp simd
+            for (int i = window.i0; i <= window.i1; ++i) {
+                Q_row[i] += power * shape(x[i] - x_src, dy);
+            }
+        }
+    }
+
+protected:
+    const char* name_;
+    Shape shape_;
+    double power_, reach_x_, reach_y_;
+};
+
+// Electric resistance welding: bulk and contact Joule heating of a Gaussian
+// current density J0 exp(-r² / w²). The contact resistance follows the mean
+// temperature of the plate: full below 0.8 T_melt, falling linearly to
+// melt_factor at T_melt.
+class ResistanceSource : public ShapedSource<GaussianShape> {
+public:
+    explicit ResistanceSource(const SimulationConfig& c)
+        : ShapedSource("electric resistance (ERW)",
+                       GaussianShape{0.0, 2.0 / (c.erw_contact_width * c.erw_contact_width)}, 0.0,
+                       4.0 * c.erw_contact_width / std::sqrt(2.0), 4.0 * c.erw_contact_width / std::sqrt(2.0)),
+          eta_(processEfficiency(c)), J0_sq_(c.erw_current_density * c.erw_current_density),
+          sigma_e_(c.erw_sigma_e), w_(c.erw_contact_width), R_base_(c.erw_contact_resistance),
+          melt_factor_(c.erw_melt_factor), T_melt_((c.mat_1_T_melt + c.mat_2_T_melt) / 2.0),
+          thickness_(c.thickness) {
+        setContactResistance(R_base_);
+    }
+
+    void update(const std::vector<double>& T) override {
+        // Chunk sums, then a serial total: the mean does not depend on the
+        // thread count
+        const int N = static_cast<int>(T.size());
+        const int chunk = 4096;
+        const int chunks = (N + chunk - 1) / chunk;
+        std::vector<double> sums(chunks, 0.0);
+
+        #pragma omp parallel for
+        for (int c = 0; c < chunks; ++c) {
+            double sum = 0.0;
+            const int end = std::min(N, (c + 1) * chunk);
+            for (int idx = c * chunk; idx < end; ++idx) {
+                sum += contactFactor(T[idx] / T_melt_);
+            }
+            sums[c] = sum;
+        }
+
+        double total = 0.0;
+        for (double s : sums) {
+            total += s;
+        }
+        setContactResistance(R_base_ * (N > 0 ? total / N : 1.0));
+    }
+
+private:
+    double eta_, J0_sq_, sigma_e_, w_, R_base_, melt_factor_, T_melt_, thickness_;
+
+    double contactFactor(double ratio) const {
+        if (ratio < 0.8) {
+            return 1.0;
+        } else if (ratio < 1.0) {
+            return 1.0 - (ratio - 0.8) / 0.2 * (1.0 - melt_factor_);
+        }
+        return melt_factor_;
+    }
+
+    // J² decays twice as fast as J, and the contact resistance acts over a
+    // layer a third of the contact width thick. The plane integral of
+    // exp(-2 r² / w²) is pi w² / 2.
+    void setContactResistance(double R_contact) {
+        shape_.peak = eta_ * J0_sq_ * (1.0 / sigma_e_ + R_contact / (w_ / 3.0));
+        power_ = shape_.peak * M_PI * w_ * w_ / 2.0 * thickness_;
+    }
+};
+
+void requirePositive(double value, const char* name, const std::string& process) {
+    if (!(value > 0.0)) {
+        throw std::invalid_argument(std::string(name) + " must be positive for weld_process " + process);
+    }
+}
+
+std::unique_ptr<HeatSource> makeGoldak(const SimulationConfig& c) {
+    const double Q = processEfficiency(c) * c.V * c.I;
+    GoldakShape shape{c.a * c.a, c.b * c.b, (c.ff * Q) / (c.a * c.b * M_PI), (c.fr * Q) / (c.a * c.b * M_PI),
+                      c.thickness};
+    // Below exp(-16) of the peak beyond four semi-axes
+    return std::make_unique<ShapedSource<GoldakShape>>("Goldak arc", shape, Q, 4.0 * c.a, 4.0 * c.b);
+}
+
+std::unique_ptr<HeatSource> makeElectronBeam(const SimulationConfig& c) {
+    requirePositive(c.R_beam, "R_beam", c.weld_process);
+    requirePositive(c.H_beam, "H_beam", c.weld_process);
+    const double Q = processEfficiency(c) * c.Q_beam;
+    const double R = c.R_beam;
+    GaussianShape shape{Q / (M_PI * R * R * c.H_beam), 1.0 / (R * R)};
+    return std::make_unique<ShapedSource<GaussianShape>>("electron beam (EBW)", shape,
+                                                         Q * c.thickness / c.H_beam, 4.0 * R, 4.0 * R);
+}
+
+std::unique_ptr<HeatSource> makeLaserBeam(const SimulationConfig& c) {
+    requirePositive(c.R_beam, "R_beam", c.weld_process);
+    const double Q = processEfficiency(c) * c.Q_beam;
+    const double R = c.R_beam;
+    const double reach = 4.0 * R / std::sqrt(2.0);
+    GaussianShape shape{2.0 * Q / (M_PI * R * R) / c.thickness, 2.0 / (R * R)};
+    return std::make_unique<ShapedSource<GaussianShape>>("laser beam (LBW)", shape, Q, reach, reach);
+}
+
+std::unique_ptr<HeatSource> makePlasmaArc(const SimulationConfig& c) {
+    requirePositive(c.R_beam, "R_beam", c.weld_process);
+    requirePositive(c.H_beam, "H_beam", c.weld_process);
+    const double Q = processEfficiency(c) * c.V * c.I;
+    const double R = c.R_beam;
+    const double reach = 4.0 * R / std::sqrt(3.0);
+    GaussianShape shape{3.0 * Q / (M_PI * R * R * c.H_beam), 3.0 / (R * R)};
+    return std::make_unique<ShapedSource<GaussianShape>>("plasma arc (PAW)", shape,
+                                                         Q * c.thickness / c.H_beam, reach, reach);
+}
+
+std::unique_ptr<HeatSource> makeSubmergedArc(const SimulationConfig& c) {
+    requirePositive(c.a, "a", c.weld_process);
+    requirePositive(c.b, "b", c.weld_process);
+    const double Q = processEfficiency(c) * c.V * c.I;
+    EllipticShape shape{3.0 * Q / (M_PI * c.a * c.b) / c.thickness, 3.0 / (c.a * c.a), 3.0 / (c.b * c.b)};
+    return std::make_unique<ShapedSource<EllipticShape>>("submerged arc (SAW)", shape, Q,
+                                                         4.0 * c.a / std::sqrt(3.0), 4.0 * c.b / std::sqrt(3.0));
+}
+
+std::unique_ptr<HeatSource> makeResistance(const SimulationConfig& c) {
+    requirePositive(c.erw_contact_width, "erw_contact_width", c.weld_process);
+    requirePositive(c.erw_sigma_e, "erw_sigma_e", c.weld_process);
+    return std::make_unique<ResistanceSource>(c);
+}
+
+// Dispatch table. Each shape's kernel is instantiated once and shared by
+// the processes that use it.
+struct SourceEntry {
+    const char* process;
+    std::unique_ptr<HeatSource> (*make)(const SimulationConfig&);
+};
+
+const SourceEntry SOURCES[] = {
+    {"TIG", makeGoldak},
+    {"Electrode", makeGoldak},
+    {"Custom", makeGoldak},
+    {"EBW", makeElectronBeam},
+    {"LBW", makeLaserBeam},
+    {"PAW", makePlasmaArc},
+    {"SAW", makeSubmergedArc},
+    {"ERW", makeResistance},
+};
+
+const SourceEntry* findSource(const std::string& process) {
+    for (const auto& entry : SOURCES) {
+        if (process == entry.process) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool isWeldProcess(const std::string& process) {
+    return findSource(process) != nullptr;
+}
+
+bool isGoldakProcess(const std::string& process) {
+    const SourceEntry* entry = findSource(process);
+    return entry && entry->make == makeGoldak;
+}
+
+std::unique_ptr<HeatSource> makeHeatSource(const SimulationConfig& c) {
+    const SourceEntry* entry = findSource(c.weld_process);
+    if (!entry) {
+        throw std::invalid_argument("Invalid weld_process '" + c.weld_process +
+                                    "'. Use TIG, Electrode, Custom, EBW, LBW, PAW, SAW or ERW.");
+    }
+    if (entry->make != makeGoldak) {
+        requirePositive(c.thickness, "thickness", c.weld_process);
+    }
+    return entry->make(c);
+}
@@ -0,0 +1,64 @@
+#ifndef HEAT_SOURCE_H
+#define HEAT_SOURCE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "WeldingSimulation.h"
+
+// Heat input of one welding process: the volumetric source term (W/m³) on
+// the grid for a given source centre. The model follows weld_process:
+//
+//   TIG, Electrode, Custom  Goldak double ellipsoid (a, b, ff, fr), power eta V I
+//   EBW   electron beam: Gaussian cylinder of radius R_beam and depth H_beam,
+//         Q = eta Q_beam / (pi R^2 H) exp(-r^2 / R^2)
+//   LBW   laser: surface Gaussian, q = 2 eta Q_beam / (pi R^2) exp(-2 r^2 / R^2)
+//   PAW   plasma arc: Gaussian cylinder, Q = 3 P / (pi R^2 H) exp(-3 r^2 / R^2)
+//   SAW   submerged arc: elliptical Gaussian with semi-axes a and b,
+//         q = 3 P / (pi a b) exp(-3 xi^2 / a^2 - 3 eta^2 / b^2)
+//   ERW   electric resistance: Joule heating of a Gaussian current density
+//         J = J0 exp(-r^2 / w^2), Q = eta J^2 (1 / sigma_e + R_c / (w / 3)),
+//         with the contact resistance R_c falling towards the melting point
+//
+// where P = eta V I for the arc processes. Surface fluxes q are spread over
+// the plate thickness. The solver evaluates a source only over its reach()
+// window, through accumulate().
+class HeatSource {
+public:
+    virtual ~HeatSource() = default;
+
+    // Process description for the log, e.g. "electron beam (EBW)"
+    virtual const char* name() const = 0;
+
+    // Power deposited in the plate (W)
+    virtual double power() const = 0;
+
+    // Half-widths (m) in x and y beyond which the source is below exp(-16)
+    // of its peak
+    virtual void reach(double& reach_x, double& reach_y) const = 0;
+
+    // Called with the current field once per step before accumulate(), for
+    // temperature-dependent sources
+    virtual void update(const std::vector<double>& T) { (void)T; }
+
+    // Add the volumetric heat input of the cells in `window` (inside the
+    // grid), with the source centred at (x_src, y_src) and scaled by `power`
+    // (fraction of the nominal power, e.g. a TorchPath ramp), to Q, a
+    // row-major array of the grid. Serial: several sources share Q, so the
+    // caller splits the rows between threads.
+    virtual void accumulate(const SimulationGrid& grid, double x_src, double y_src, double power,
+                            const CellWindow& window, double* Q) const = 0;
+};
+
+// Whether weld_process names a known process
+bool isWeldProcess(const std::string& process);
+
+// Whether the process uses the Goldak arc model (TIG, Electrode, Custom)
+bool isGoldakProcess(const std::string& process);
+
+// Source model of config.weld_process. Throws std::invalid_argument for an
+// unknown process or non-positive source dimensions.
+std::unique_ptr<HeatSource> makeHeatSource(const SimulationConfig& config);
+
+#endif // HEAT_SOURCE_H
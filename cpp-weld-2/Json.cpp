@@ -0,0 +1,429 @@
+#include "Json.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    if (type != Type::Object) {
+        return nullptr;
+    }
+    for (const auto& member : object) {
+        if (member.first == key) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+JsonValue JsonValue::makeNumber(double value) {
+    JsonValue v;
+    v.type = Type::Number;
+    v.number = value;
+    return v;
+}
+
+JsonValue JsonValue::makeString(const std::string& value) {
+    JsonValue v;
+    v.type = Type::String;
+    v.string = value;
+    return v;
+}
+
+JsonValue JsonValue::makeBool(bool value) {
+    JsonValue v;
+    v.type = Type::Bool;
+    v.boolean = value;
+    return v;
+}
+
+JsonValue JsonValue::makeArray() {
+    JsonValue v;
+    v.type = Type::Array;
+    return v;
+}
+
+JsonValue JsonValue::makeObject() {
+    JsonValue v;
+    v.type = Type::Object;
+    return v;
+}
+
+JsonValue& JsonValue::set(const std::string& key, JsonValue value) {
+    object.emplace_back(key, std::move(value));
+    return object.back().second;
+}
+
+namespace {
+
+// Recursive-descent parser over the whole text
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+
+    JsonValue parseDocument() {
+        JsonValue value = parseValue(0);
+        skipWhitespace();
+        if (pos_ != text_.size()) {
+            fail("unexpected trailing characters");
+        }
+        return value;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    const std::string& text_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        int line = 1, column = 1;
+        for (size_t k = 0; k < pos_ && k < text_.size(); ++k) {
+            if (text_[k] == '\n') {
+                ++line;
+                column = 1;
+            } else {
+                ++column;
+            }
+        }
+        throw std::runtime_error("JSON line " + std::to_string(line) + ", column " +
+                                 std::to_string(column) + ": " + message);
+    }
+
+    void skipWhitespace() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    char peek() {
+        skipWhitespace();
+        if (pos_ >= text_.size()) {
+            fail("unexpected end of input");
+        }
+        return text_[pos_];
+    }
+
+    void expect(char ch) {
+        if (peek() != ch) {
+            fail(std::string("expected '") + ch + "'");
+        }
+        ++pos_;
+    }
+
+    bool consumeLiteral(const char* literal) {
+        size_t len = std::char_traits<char>::length(literal);
+        if (text_.compare(pos_, len, literal) == 0) {
+            pos_ += len;
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parseValue(int depth) {
+        if (depth > MAX_DEPTH) {
+            fail("nesting too deep");
+        }
+
+        char ch = peek();
+        if (ch == '{') {
+            return parseObject(depth);
+        } else if (ch == '[') {
+            return parseArray(depth);
+        } else if (ch == '"') {
+            return JsonValue::makeString(parseString());
+        } else if (ch == '-' || (ch >= '0' && ch <= '9')) {
+            return JsonValue::makeNumber(parseNumber());
+        } else if (consumeLiteral("true")) {
+            return JsonValue::makeBool(true);
+        } else if (consumeLiteral("false")) {
+            return JsonValue::makeBool(false);
+        } else if (consumeLiteral("null")) {
+            return JsonValue();
+        }
+        fail("unexpected character");
+    }
+
+    JsonValue parseObject(int depth) {
+        JsonValue value = JsonValue::makeObject();
+        expect('{');
+        if (peek() == '}') {
+            ++pos_;
+            return value;
+        }
+        while (true) {
+            if (peek() != '"') {
+                fail("expected member name");
+            }
+            std::string key = parseString();
+            if (value.find(key)) {
+                fail("duplicate member '" + key + "'");
+            }
+            expect(':');
+            value.set(key, parseValue(depth + 1));
+
+            char ch = peek();
+            ++pos_;
+            if (ch == '}') {
+                return value;
+            } else if (ch != ',') {
+                --pos_;
+                fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    JsonValue parseArray(int depth) {
+        JsonValue value = JsonValue::makeArray();
+        expect('[');
+        if (peek() == ']') {
+            ++pos_;
+            return value;
+        }
+        while (true) {
+            value.array.push_back(parseValue(depth + 1));
+
+            char ch = peek();
+            ++pos_;
+            if (ch == ']') {
+                return value;
+            } else if (ch != ',') {
+                --pos_;
+                fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        while (true) {
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            char ch = text_[pos_++];
+            if (ch == '"') {
+                return out;
+            } else if (static_cast<unsigned char>(ch) < 0x20) {
+                --pos_;
+                fail("control character in string");
+            } else if (ch != '\\') {
+                out += ch;
+                continue;
+            }
+
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+            char esc = text_[pos_++];
+            switch (esc) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': appendUtf8(out, parseCodePoint()); break;
+                default:
+                    --pos_;
+                    fail("invalid escape sequence");
+            }
+        }
+    }
+
+    unsigned parseHex4() {
+        if (pos_ + 4 > text_.size()) {
+            fail("truncated \\u escape");
+        }
+        unsigned code = 0;
+        for (int k = 0; k < 4; ++k) {
+            char ch = text_[pos_++];
+            code <<= 4;
+            if (ch >= '0' && ch <= '9') code |= ch - '0';
+            else if (ch >= 'a' && ch <= 'f') code |= ch - 'a' + 10;
+            else if (ch >= 'A' && ch <= 'F') code |= ch - 'A' + 10;
+            else fail("invalid \\u escape");
+        }
+        return code;
+    }
+
+    unsigned parseCodePoint() {
+        unsigned code = parseHex4();
+        // Surrogate pair
+        if (code >= 0xD800 && code <= 0xDBFF && text_.compare(pos_, 2, "\\u") == 0) {
+            pos_ += 2;
+            unsigned low = parseHex4();
+            if (low < 0xDC00 || low > 0xDFFF) {
+                fail("invalid surrogate pair");
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        return code;
+    }
+
+    static void appendUtf8(std::string& out, unsigned code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    double parseNumber() {
+        // Validate the JSON number grammar, then convert with strtod
+        const size_t start = pos_;
+        auto digits = [&]() {
+            size_t first = pos_;
+            while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') {
+                ++pos_;
+            }
+            return pos_ > first;
+        };
+
+        if (text_[pos_] == '-') {
+            ++pos_;
+        }
+        if (pos_ < text_.size() && text_[pos_] == '0') {
+            ++pos_;
+        } else if (!digits()) {
+            fail("invalid number");
+        }
+        if (pos_ < text_.size() && text_[pos_] == '.') {
+            ++pos_;
+            if (!digits()) {
+                fail("invalid number");
+            }
+        }
+        if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+            ++pos_;
+            if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) {
+                ++pos_;
+            }
+            if (!digits()) {
+                fail("invalid number");
+            }
+        }
+
+        return std::strtod(text_.substr(start, pos_ - start).c_str(), nullptr);
+    }
+};
+
+void writeString(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char ch : s) {
+        switch (ch) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(ch) << std::dec << std::setfill(' ');
+                } else {
+                    out << ch;
+                }
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+JsonValue parseJson(const std::string& text) {
+    return JsonParser(text).parseDocument();
+}
+
+JsonValue readJsonFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open JSON file " + filename);
+    }
+    std::ostringstream ss;
+    ss << file.rdbuf();
+
+    try {
+        return parseJson(ss.str());
+    } catch (const std::exception& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+}
+
+void writeJson(std::ostream& out, const JsonValue& value, int indent) {
+    const bool compact = indent < 0;
+    const std::string pad(compact ? 0 : indent + 4, ' ');
+    const std::string close_pad(compact ? 0 : indent, ' ');
+    const char* const separator = compact ? "," : ",\n";
+    const char* const last = compact ? "" : "\n";
+    const int inner = compact ? indent : indent + 4;
+
+    switch (value.type) {
+        case JsonValue::Type::Null:
+            out << "null";
+            break;
+        case JsonValue::Type::Bool:
+            out << (value.boolean ? "true" : "false");
+            break;
+        case JsonValue::Type::Number:
+            if (std::isfinite(value.number)) {
+                // Shortest of 15 or 17 digits that reads back exactly
+                std::ostringstream num;
+                num << std::setprecision(15) << value.number;
+                if (std::strtod(num.str().c_str(), nullptr) != value.number) {
+                    num.str("");
+                    num << std::setprecision(17) << value.number;
+                }
+                out << num.str();
+            } else {
+                out << "null";  // JSON has no NaN/Inf
+            }
+            break;
+        case JsonValue::Type::String:
+            writeString(out, value.string);
+            break;
+        case JsonValue::Type::Array:
+            if (value.array.empty()) {
+                out << "[]";
+                break;
+            }
+            out << "[" << last;
+            for (size_t k = 0; k < value.array.size(); ++k) {
+                out << pad;
+                writeJson(out, value.array[k], inner);
+                out << (k + 1 < value.array.size() ? separator : last);
+            }
+            out << close_pad << "]";
+            break;
+        case JsonValue::Type::Object:
+            if (value.object.empty()) {
+                out << "{}";
+                break;
+            }
+            out << "{" << last;
+            for (size_t k = 0; k < value.object.size(); ++k) {
+                out << pad;
+                writeString(out, value.object[k].first);
+                out << (compact ? ":" : ": ");
+                writeJson(out, value.object[k].second, inner);
+                out << (k + 1 < value.object.size() ? separator : last);
+            }
+            out << close_pad << "}";
+            break;
+    }
+}
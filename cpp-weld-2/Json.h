@@ -0,0 +1,54 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <ostream>
+
+// Minimal JSON document model: enough for configuration files and small
+// result records, with no external dependency.
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;  // In file order
+
+    bool isNull() const { return type == Type::Null; }
+    bool isBool() const { return type == Type::Bool; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isString() const { return type == Type::String; }
+    bool isArray() const { return type == Type::Array; }
+    bool isObject() const { return type == Type::Object; }
+
+    // Member lookup on objects; nullptr if absent or not an object
+    const JsonValue* find(const std::string& key) const;
+
+    static JsonValue makeNumber(double value);
+    static JsonValue makeString(const std::string& value);
+    static JsonValue makeBool(bool value);
+    static JsonValue makeArray();
+    static JsonValue makeObject();
+
+    // Append a member to an object (no duplicate check)
+    JsonValue& set(const std::string& key, JsonValue value);
+};
+
+// Parse a complete JSON text. Throws std::runtime_error with the line and
+// column of the first syntax error.
+JsonValue parseJson(const std::string& text);
+
+// Read and parse a JSON file. Throws std::runtime_error (prefixed with the
+// file name) if it cannot be read or parsed.
+JsonValue readJsonFile(const std::string& filename);
+
+// Write value as indented JSON, or on a single line when indent < 0
+// (JSON_COMPACT); numbers round-trip exactly
+const int JSON_COMPACT = -1;
+void writeJson(std::ostream& out, const JsonValue& value, int indent = 0);
+
+#endif // JSON_H
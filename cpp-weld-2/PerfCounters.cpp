@@ -0,0 +1,198 @@
+#include "PerfCounters.h"
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <chrono>
+#include <algorithm>
+#include <omp.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char* const EVENT_NAMES[] = {"cycles", "instructions", "llc_misses", "task_clock"};
+
+static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) == static_cast<size_t>(PerfEvent::Count),
+              "one name per perf event");
+
+// Triad arrays: 3 x 64 MB, far beyond any last-level cache
+const size_t STREAM_ELEMENTS = size_t(1) << 23;
+const int STREAM_PASSES = 5;
+
+#ifdef __linux__
+// Counter for the calling thread; -1 and errno set on failure
+int openEvent(PerfEvent event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (event) {
+        case PerfEvent::Cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::Instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::LlcMisses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        default:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_TASK_CLOCK;
+            break;
+    }
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+} // namespace
+
+const char* perfEventName(PerfEvent event) {
+    return EVENT_NAMES[static_cast<int>(event)];
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+bool PerfCounters::open(int threads, std::string& error) {
+    close();
+    error.clear();
+#ifdef __linux__
+    threads = std::max(1, threads);
+    std::vector<int> fds(static_cast<size_t>(threads) * EVENTS, -1);
+    std::vector<int> errors(static_cast<size_t>(threads) * EVENTS, 0);
+
+    #pragma omp parallel num_threads(threads)
+    {
+        const int thread = omp_get_thread_num();
+        for (int e = 0; e < EVENTS; ++e) {
+            const size_t k = static_cast<size_t>(thread) * EVENTS + e;
+            fds[k] = openEvent(static_cast<PerfEvent>(e));
+            errors[k] = (fds[k] < 0) ? errno : 0;
+        }
+    }
+
+    // The region may have run with fewer threads than requested
+    bool any = false;
+    std::string missing;
+    int first_error = 0;
+    for (int e = 0; e < EVENTS; ++e) {
+        bool everywhere = true;
+        for (int t = 0; t < threads; ++t) {
+            const size_t k = static_cast<size_t>(t) * EVENTS + e;
+            if (fds[k] < 0) {
+                everywhere = false;
+                first_error = first_error ? first_error : errors[k];
+            }
+        }
+        if (everywhere) {
+            any = true;
+        } else {
+            missing += std::string(missing.empty() ? "" : ", ") + perfEventName(static_cast<PerfEvent>(e));
+        }
+    }
+
+    if (!any) {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        error = std::string("perf_event_open failed: ") +
+                (first_error ? std::strerror(first_error) : "no OpenMP threads");
+        return false;
+    }
+    if (!missing.empty()) {
+        error = "unavailable events: " + missing +
+                (first_error ? " (" + std::string(std::strerror(first_error)) + ")" : "");
+    }
+
+    threads_ = threads;
+    fds_ = std::move(fds);
+    return true;
+#else
+    (void)threads;
+    error = "hardware counters need Linux perf_event_open";
+    return false;
+#endif
+}
+
+void PerfCounters::close() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+    fds_.clear();
+    threads_ = 0;
+}
+
+bool PerfCounters::available(PerfEvent event) const {
+    if (threads_ == 0) {
+        return false;
+    }
+    for (int t = 0; t < threads_; ++t) {
+        if (fds_[static_cast<size_t>(t) * EVENTS + static_cast<int>(event)] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PerfCounters::read(std::vector<double>& values) const {
+    values.assign(fds_.size(), 0.0);
+#ifdef __linux__
+    for (size_t k = 0; k < fds_.size(); ++k) {
+        if (fds_[k] < 0) {
+            continue;
+        }
+        // value, time enabled, time running
+        std::uint64_t data[3] = {0, 0, 0};
+        if (::read(fds_[k], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        if (data[2] > 0) {
+            values[k] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+    }
+#endif
+}
+
+double measureMemoryBandwidth() {
+    const long n = static_cast<long>(STREAM_ELEMENTS);
+    std::vector<double> a(STREAM_ELEMENTS), b(STREAM_ELEMENTS), c(STREAM_ELEMENTS);
+
+    // First touch in parallel, so pages land near the threads that use them
+    #pragma omp parallel for
+    for (long i = 0; i < n; ++i) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+
+    double best = 1e300;
+    for (int pass = 0; pass < STREAM_PASSES; ++pass) {
+        auto start = std::chrono::steady_clock::now();
+        #pragma omp parallel for
+        for (long i = 0; i < n; ++i) {
+            a[i] = b[i] + 3.0 * c[i];
+        }
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Two reads and one write per element (write-allocate traffic not counted, as in STREAM)
+    return 3.0 * sizeof(double) * n / best;
+}
@@ -0,0 +1,63 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <vector>
+#include <string>
+
+// Counters read by PerfCounters
+enum class PerfEvent {
+    Cycles,         // CPU cycles (user space)
+    Instructions,   // Retired instructions
+    LlcMisses,      // Last-level cache misses (PERF_COUNT_HW_CACHE_MISSES)
+    TaskClock,      // CPU time of the thread (ns, software event)
+    Count
+};
+
+const char* perfEventName(PerfEvent event);
+
+// Per-thread counters of an OpenMP team via Linux perf_event_open, with no
+// library dependency.
+//
+// open() runs a parallel region and opens one counter per event on each
+// thread; since OpenMP reuses its team threads, the counters then follow
+// the threads that execute the solver's parallel loops. Events the kernel
+// or the (virtual) machine does not provide are left out. Counters count
+// user-space events only, so perf_event_paranoid <= 2 suffices. Values are
+// scaled for multiplexing.
+class PerfCounters {
+public:
+    static const int EVENTS = static_cast<int>(PerfEvent::Count);
+
+    PerfCounters() = default;
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Open the counters on each of `threads` OpenMP threads. Returns false
+    // with the reason in `error` if no event could be opened; otherwise
+    // `error` lists the events that are unavailable (empty if none).
+    bool open(int threads, std::string& error);
+
+    void close();
+
+    bool isOpen() const { return threads_ > 0; }
+    int threads() const { return threads_; }
+
+    // True if the event is counted on every thread
+    bool available(PerfEvent event) const;
+
+    // Current values, values[thread * EVENTS + event] (0 where unavailable)
+    void read(std::vector<double>& values) const;
+
+private:
+    int threads_ = 0;
+    std::vector<int> fds_;   // [thread * EVENTS + event], -1 = unavailable
+};
+
+// Sustained memory bandwidth in bytes/s, as the best of a few STREAM triad
+// passes (a[i] = b[i] + s c[i]) over arrays much larger than the caches,
+// run on the current OpenMP threads. Used as the roofline bandwidth ceiling.
+double measureMemoryBandwidth();
+
+#endif // PERF_COUNTERS_H
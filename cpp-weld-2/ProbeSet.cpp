@@ -0,0 +1,141 @@
+#include "ProbeSet.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <numeric>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+std::vector<ProbeSpec> readProbeFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open probe file " + filename);
+    }
+
+    std::vector<ProbeSpec> probes;
+    std::string line;
+    int line_number = 0;
+
+    while (std::getline(file, line)) {
+        ++line_number;
+        if (line.empty() || line[0] == '#' || line.rfind("name,", 0) == 0) {
+            continue;
+        }
+
+        std::stringstream ss(line);
+        std::string field;
+        std::vector<std::string> fields;
+        while (std::getline(ss, field, ',')) {
+            fields.push_back(field);
+        }
+
+        if (fields.size() < 3 || fields.size() > 4) {
+            throw std::runtime_error(filename + ":" + std::to_string(line_number) +
+                                     ": expected name,x,y[,interval]");
+        }
+
+        ProbeSpec probe;
+        try {
+            probe.name = fields[0];
+            probe.x = std::stod(fields[1]);
+            probe.y = std::stod(fields[2]);
+            if (fields.size() == 4) {
+                probe.interval = std::stoi(fields[3]);
+            }
+        } catch (const std::exception&) {
+            throw std::runtime_error(filename + ":" + std::to_string(line_number) +
+                                     ": invalid number");
+        }
+        probes.push_back(probe);
+    }
+
+    return probes;
+}
+
+void ProbeSet::setup(const std::vector<ProbeSpec>& specs,
+                     const std::vector<double>& x, const std::vector<double>& y) {
+    const int nx = static_cast<int>(x.size());
+    const int ny = static_cast<int>(y.size());
+    const double dx = x[1] - x[0];
+    const double dy = y[1] - y[0];
+    const double snap = 1e-9;  // Treat positions this close to a node as on it
+
+    specs_ = specs;
+    nx_ = nx;
+    const size_t n = specs_.size();
+    base_.resize(n);
+    w00_.resize(n);
+    w10_.resize(n);
+    w01_.resize(n);
+    w11_.resize(n);
+    interval_.resize(n);
+
+    row_interval_ = 0;
+
+    for (size_t k = 0; k < n; ++k) {
+        const ProbeSpec& p = specs_[k];
+        double fi = (p.x - x[0]) / dx;
+        double fj = (p.y - y[0]) / dy;
+
+        // Written as "not inside" so NaN coordinates are rejected too
+        if (!(fi >= -snap && fi <= nx - 1 + snap && fj >= -snap && fj <= ny - 1 + snap)) {
+            throw std::runtime_error("Probe '" + p.name + "' lies outside the plate");
+        }
+        if (p.interval < 1) {
+            throw std::runtime_error("Probe '" + p.name + "' has a non-positive interval");
+        }
+
+        // Lower-left corner, kept one cell inside so the +1 neighbours exist
+        int i0 = std::min(std::max(static_cast<int>(std::floor(fi + snap)), 0), nx - 2);
+        int j0 = std::min(std::max(static_cast<int>(std::floor(fj + snap)), 0), ny - 2);
+        double fx = std::min(std::max(fi - i0, 0.0), 1.0);
+        double fy = std::min(std::max(fj - j0, 0.0), 1.0);
+        if (fx < snap) fx = 0.0;
+        if (fy < snap) fy = 0.0;
+
+        base_[k] = j0 * nx + i0;
+        w00_[k] = (1.0 - fx) * (1.0 - fy);
+        w10_[k] = fx * (1.0 - fy);
+        w01_[k] = (1.0 - fx) * fy;
+        w11_[k] = fx * fy;
+        interval_[k] = p.interval;
+
+        row_interval_ = std::gcd(row_interval_, p.interval);
+    }
+
+    if (row_interval_ == 0) {
+        row_interval_ = 1;
+    }
+
+    mixed_intervals_ = false;
+    for (size_t k = 0; k < n; ++k) {
+        mixed_intervals_ = mixed_intervals_ || interval_[k] != row_interval_;
+    }
+}
+
+void ProbeSet::sample(const double* T, int step, double* out) const {
+    const int n = size();
+    const int nx = nx_;
+    const int* base = base_.data();
+    const double* w00 = w00_.data();
+    const double* w10 = w10_.data();
+    const double* w01 = w01_.data();
+    const double* w11 = w11_.data();
+
+    #pragma omp simd
+    for (int k = 0; k < n; ++k) {
+        const int b = base[k];
+        out[k] = w00[k] * T[b] + w10[k] * T[b + 1] +
+                 w01[k] * T[b + nx] + w11[k] * T[b + nx + 1];
+    }
+
+    if (mixed_intervals_) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (int k = 0; k < n; ++k) {
+            if (step % interval_[k] != 0) {
+                out[k] = nan;
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef PROBE_SET_H
+#define PROBE_SET_H
+
+#include <vector>
+#include <string>
+
+// Virtual thermocouple at a physical position on the plate
+struct ProbeSpec {
+    std::string name;
+    double x = 0.0;        // Position in x (m)
+    double y = 0.0;        // Position in y (m)
+    int interval = 1;      // Sample every N time steps
+};
+
+// Read probes from a CSV file with lines "name,x,y[,interval]".
+// Blank lines, '#' comments and a "name,..." header are ignored.
+// Throws std::runtime_error on unreadable files or malformed lines.
+std::vector<ProbeSpec> readProbeFile(const std::string& filename);
+
+// Set of probes sampled by bilinear interpolation.
+//
+// setup() resolves every probe to the lower-left cell corner and four
+// weights once; sample() is then a single gather over flat arrays with no
+// per-probe branching, so hundreds of probes cost far less than one stencil
+// sweep.
+class ProbeSet {
+public:
+    // Resolve probe positions on the tensor grid x (size nx) by y (size ny).
+    // Throws std::runtime_error for probes outside the plate.
+    void setup(const std::vector<ProbeSpec>& specs,
+               const std::vector<double>& x, const std::vector<double>& y);
+
+    int size() const { return static_cast<int>(specs_.size()); }
+    const ProbeSpec& spec(int k) const { return specs_[k]; }
+
+    // Steps between history rows: the gcd of all probe intervals
+    int rowInterval() const { return row_interval_; }
+
+    // Interpolate all probes from the row-major field T into out[size()].
+    // Probes whose interval does not divide `step` are set to NaN.
+    void sample(const double* T, int step, double* out) const;
+
+private:
+    std::vector<ProbeSpec> specs_;
+    int nx_ = 0;
+    int row_interval_ = 1;
+    bool mixed_intervals_ = false;  // Some probes skip rows
+
+    // Struct-of-arrays interpolation data
+    std::vector<int> base_;     // Linear index of the lower-left corner
+    std::vector<double> w00_, w10_, w01_, w11_;
+    std::vector<int> interval_;
+};
+
+#endif // PROBE_SET_H
@@ -0,0 +1,374 @@
+#include "Profiler.h"
+#include "Json.h"
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+const char* const PHASE_NAMES[] = {
+    "heat_flux", "properties", "stencil", "accumulators", "zones",
+    "monitoring", "frame_export", "snapshot", "checkpoint"
+};
+
+static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == static_cast<size_t>(ProfilePhase::Count),
+              "one name per profile phase");
+
+const int PHASE_COUNT = static_cast<int>(ProfilePhase::Count);
+const int EVENTS = PerfCounters::EVENTS;
+
+// Bytes moved to or from memory per last-level cache miss
+const double CACHE_LINE = 64.0;
+
+// Roofline verdicts: memory bound at this fraction of the bandwidth
+// ceiling, compute bound above this IPC, latency bound otherwise
+const double MEMORY_BOUND_FRACTION = 0.5;
+const double COMPUTE_BOUND_IPC = 1.5;
+
+double eventValue(const std::vector<double>& values, int thread, PerfEvent event) {
+    return values[static_cast<size_t>(thread) * EVENTS + static_cast<int>(event)];
+}
+
+double eventSum(const std::vector<double>& values, int threads, PerfEvent event) {
+    double sum = 0.0;
+    for (int t = 0; t < threads; ++t) {
+        sum += eventValue(values, t, event);
+    }
+    return sum;
+}
+
+} // namespace
+
+const char* profilePhaseName(ProfilePhase phase) {
+    return PHASE_NAMES[static_cast<int>(phase)];
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+std::int64_t Profiler::now() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& buffer : buffers_) {
+        buffer->samples.clear();
+        for (auto& totals : buffer->totals) {
+            totals = PhaseTotals();
+        }
+        buffer->dropped = 0;
+    }
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        counter_total_[p].clear();
+    }
+    counter_threads_ = 0;
+    if (counters_enabled_.load()) {
+        counter_threads_ = counters_.threads();
+        counters_active_.store(true);
+    }
+    start_ns_ = now();
+    stop_ns_ = start_ns_;
+    active_.store(true);
+}
+
+void Profiler::stop() {
+    active_.store(false);
+    stop_ns_ = now();
+    counters_active_.store(false);
+    counters_enabled_.store(false);
+    counters_.close();
+}
+
+bool Profiler::enableCounters(int threads, std::string& error) {
+    if (!counters_.open(threads, error)) {
+        return false;
+    }
+    for (int e = 0; e < EVENTS; ++e) {
+        counter_events_[e] = counters_.available(static_cast<PerfEvent>(e));
+    }
+    peak_bandwidth_ = measureMemoryBandwidth();
+    counters_enabled_.store(true);
+    return true;
+}
+
+void Profiler::beginCounters(ProfilePhase phase) {
+    counters_.read(counter_begin_[static_cast<int>(phase)]);
+}
+
+void Profiler::endCounters(ProfilePhase phase) {
+    const int p = static_cast<int>(phase);
+    counters_.read(counter_scratch_);
+    std::vector<double>& total = counter_total_[p];
+    total.resize(counter_scratch_.size(), 0.0);
+    for (size_t k = 0; k < total.size(); ++k) {
+        total[k] += counter_scratch_[k] - counter_begin_[p][k];
+    }
+}
+
+std::vector<PhaseCounters> Profiler::counterSummary() const {
+    std::vector<PhaseCounters> result;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        if (!counter_total_[p].empty()) {
+            result.push_back({static_cast<ProfilePhase>(p), counter_total_[p]});
+        }
+    }
+    return result;
+}
+
+void Profiler::printCounterSummary(std::ostream& out) const {
+    if (counter_threads_ == 0) {
+        return;
+    }
+    const int threads = counter_threads_;
+    const bool cycles = counter_events_[static_cast<int>(PerfEvent::Cycles)];
+    const bool instructions = counter_events_[static_cast<int>(PerfEvent::Instructions)];
+    const bool misses = counter_events_[static_cast<int>(PerfEvent::LlcMisses)];
+    const bool task_clock = counter_events_[static_cast<int>(PerfEvent::TaskClock)];
+    const std::streamsize precision = out.precision();
+
+    double phase_seconds[PHASE_COUNT] = {};
+    for (const PhaseSummary& s : summary(false)) {
+        phase_seconds[static_cast<int>(s.phase)] = s.total;
+    }
+
+    out << "Hardware counters: " << threads << " thread(s), memory ceiling "
+        << std::setprecision(3) << peak_bandwidth_ * 1e-9 << " GB/s (STREAM triad)" << std::endl;
+    std::string missing;
+    for (int e = 0; e < EVENTS; ++e) {
+        if (!counter_events_[e]) {
+            missing += std::string(missing.empty() ? "" : ", ") + perfEventName(static_cast<PerfEvent>(e));
+        }
+    }
+    if (!missing.empty()) {
+        out << "  (not counted on this machine: " << missing << ")" << std::endl;
+    }
+
+    out << "  " << std::left << std::setw(14) << "phase" << std::right << std::setw(9) << "wall s"
+        << std::setw(9) << "CPU s" << std::setw(8) << "imbal" << std::setw(10) << "Gcycles"
+        << std::setw(7) << "IPC" << std::setw(11) << "LLC miss" << std::setw(9) << "GB/s"
+        << std::setw(8) << "% peak" << std::setw(9) << "instr/B" << "  bound" << std::endl;
+
+    auto cell = [&out](bool valid, double value, int width) {
+        if (valid) {
+            out << std::setw(width) << value;
+        } else {
+            out << std::setw(width) << "-";
+        }
+    };
+
+    for (const PhaseCounters& c : counterSummary()) {
+        const double seconds = phase_seconds[static_cast<int>(c.phase)];
+        const double cpu = eventSum(c.values, threads, PerfEvent::TaskClock) * 1e-9;
+        double busiest = 0.0;
+        for (int t = 0; t < threads; ++t) {
+            busiest = std::max(busiest, eventValue(c.values, t, PerfEvent::TaskClock) * 1e-9);
+        }
+        const double n_cycles = eventSum(c.values, threads, PerfEvent::Cycles);
+        const double n_instructions = eventSum(c.values, threads, PerfEvent::Instructions);
+        const double bytes = eventSum(c.values, threads, PerfEvent::LlcMisses) * CACHE_LINE;
+        const double bandwidth = seconds > 0.0 ? bytes / seconds : 0.0;
+        const double ipc = n_cycles > 0.0 ? n_instructions / n_cycles : 0.0;
+
+        std::string bound = "-";
+        if (misses && peak_bandwidth_ > 0.0 && bandwidth >= MEMORY_BOUND_FRACTION * peak_bandwidth_) {
+            bound = "memory";
+        } else if (cycles && instructions) {
+            bound = (ipc >= COMPUTE_BOUND_IPC) ? "compute" : "latency";
+        }
+
+        out << "  " << std::left << std::setw(14) << profilePhaseName(c.phase) << std::right
+            << std::setprecision(3);
+        cell(true, seconds, 9);
+        cell(task_clock, cpu, 9);
+        cell(task_clock && cpu > 0.0, busiest * threads / cpu, 8);
+        cell(cycles, n_cycles * 1e-9, 10);
+        cell(cycles && instructions, ipc, 7);
+        cell(misses, eventSum(c.values, threads, PerfEvent::LlcMisses), 11);
+        cell(misses, bandwidth * 1e-9, 9);
+        cell(misses && peak_bandwidth_ > 0.0, 100.0 * bandwidth / peak_bandwidth_, 8);
+        cell(misses && instructions && bytes > 0.0, n_instructions / bytes, 9);
+        out << "  " << bound << std::endl;
+    }
+    out.precision(precision);
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(std::make_unique<ThreadBuffer>());
+        buffer = buffers_.back().get();
+        buffer->id = static_cast<int>(buffers_.size());
+    }
+    return *buffer;
+}
+
+void Profiler::record(ProfilePhase phase, std::int64_t start_ns, std::int64_t end_ns) {
+    ThreadBuffer& buffer = threadBuffer();
+    const std::int64_t duration = end_ns - start_ns;
+
+    PhaseTotals& totals = buffer.totals[static_cast<int>(phase)];
+    totals.min = (totals.count == 0) ? duration : std::min(totals.min, duration);
+    totals.max = (totals.count == 0) ? duration : std::max(totals.max, duration);
+    totals.total += duration;
+    ++totals.count;
+
+    if (buffer.samples.size() < MAX_SAMPLES_PER_THREAD) {
+        buffer.samples.push_back({start_ns, duration, phase});
+    } else {
+        ++buffer.dropped;
+    }
+}
+
+std::vector<PhaseSummary> Profiler::summary(bool percentiles) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<PhaseSummary> result;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        PhaseSummary s;
+        s.phase = static_cast<ProfilePhase>(p);
+        std::int64_t min = 0, max = 0, total = 0;
+        std::vector<std::int64_t> durations;
+        for (const auto& buffer : buffers_) {
+            const PhaseTotals& t = buffer->totals[p];
+            if (t.count == 0) {
+                continue;
+            }
+            min = (s.count == 0) ? t.min : std::min(min, t.min);
+            max = (s.count == 0) ? t.max : std::max(max, t.max);
+            total += t.total;
+            s.count += t.count;
+            if (!percentiles) {
+                continue;
+            }
+            for (const Sample& sample : buffer->samples) {
+                if (sample.phase == s.phase) {
+                    durations.push_back(sample.duration);
+                }
+            }
+        }
+        if (s.count == 0) {
+            continue;
+        }
+        s.total = total * 1e-9;
+        s.min = min * 1e-9;
+        s.max = max * 1e-9;
+        if (!durations.empty()) {
+            // Nearest-rank percentile
+            size_t rank = (durations.size() * 99 + 99) / 100 - 1;
+            std::nth_element(durations.begin(), durations.begin() + rank, durations.end());
+            s.p99 = durations[rank] * 1e-9;
+        }
+        result.push_back(s);
+    }
+    return result;
+}
+
+double Profiler::elapsed() const {
+    return ((active() ? now() : stop_ns_) - start_ns_) * 1e-9;
+}
+
+std::uint64_t Profiler::droppedSamples() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint64_t dropped = 0;
+    for (const auto& buffer : buffers_) {
+        dropped += buffer->dropped;
+    }
+    return dropped;
+}
+
+void Profiler::writeReport(const std::string& filename) const {
+    const double wall = elapsed();
+
+    JsonValue phases = JsonValue::makeArray();
+    for (const PhaseSummary& s : summary()) {
+        JsonValue p = JsonValue::makeObject();
+        p.set("phase", JsonValue::makeString(profilePhaseName(s.phase)));
+        p.set("count", JsonValue::makeNumber(static_cast<double>(s.count)));
+        p.set("total_s", JsonValue::makeNumber(s.total));
+        p.set("mean_us", JsonValue::makeNumber(s.total / s.count * 1e6));
+        p.set("min_us", JsonValue::makeNumber(s.min * 1e6));
+        p.set("max_us", JsonValue::makeNumber(s.max * 1e6));
+        p.set("p99_us", JsonValue::makeNumber(s.p99 * 1e6));
+        p.set("fraction", JsonValue::makeNumber(wall > 0.0 ? s.total / wall : 0.0));
+        phases.array.push_back(p);
+    }
+
+    JsonValue report = JsonValue::makeObject();
+    report.set("elapsed_s", JsonValue::makeNumber(wall));
+    report.set("dropped_samples", JsonValue::makeNumber(static_cast<double>(droppedSamples())));
+    report.set("phases", phases);
+
+    if (counter_threads_ > 0) {
+        // Per phase and thread, available events only
+        JsonValue counter_phases = JsonValue::makeArray();
+        for (const PhaseCounters& c : counterSummary()) {
+            JsonValue per_thread = JsonValue::makeArray();
+            for (int t = 0; t < counter_threads_; ++t) {
+                JsonValue values = JsonValue::makeObject();
+                for (int e = 0; e < EVENTS; ++e) {
+                    if (counter_events_[e]) {
+                        values.set(perfEventName(static_cast<PerfEvent>(e)),
+                                   JsonValue::makeNumber(eventValue(c.values, t, static_cast<PerfEvent>(e))));
+                    }
+                }
+                per_thread.array.push_back(values);
+            }
+            JsonValue p = JsonValue::makeObject();
+            p.set("phase", JsonValue::makeString(profilePhaseName(c.phase)));
+            p.set("threads", per_thread);
+            counter_phases.array.push_back(p);
+        }
+
+        JsonValue counters = JsonValue::makeObject();
+        counters.set("threads", JsonValue::makeNumber(counter_threads_));
+        counters.set("peak_bandwidth_gb_s", JsonValue::makeNumber(peak_bandwidth_ * 1e-9));
+        counters.set("bytes_per_llc_miss", JsonValue::makeNumber(CACHE_LINE));
+        counters.set("phases", counter_phases);
+        report.set("counters", counters);
+    }
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+    writeJson(out, report);
+    out << std::endl;
+    if (!out) {
+        throw std::runtime_error("Failed to write " + filename);
+    }
+}
+
+void Profiler::writeTrace(const std::string& filename) const {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open file " + filename);
+    }
+
+    // Timestamps in microseconds from start(); written directly since a
+    // trace can hold millions of events
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for (const auto& buffer : buffers_) {
+        for (const Sample& s : buffer->samples) {
+            out << (first ? "\n" : ",\n")
+                << "{\"name\": \"" << profilePhaseName(s.phase) << "\", \"cat\": \"solver\", \"ph\": \"X\""
+                << ", \"ts\": " << (s.start - start_ns_) * 1e-3 << ", \"dur\": " << s.duration * 1e-3
+                << ", \"pid\": 1, \"tid\": " << buffer->id << "}";
+            first = false;
+        }
+    }
+    out << "\n]}" << std::endl;
+    if (!out) {
+        throw std::runtime_error("Failed to write " + filename);
+    }
+}
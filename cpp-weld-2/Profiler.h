@@ -0,0 +1,207 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <ostream>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "PerfCounters.h"
+
+// Phases of a time step timed by WELD_PROFILE_SCOPE
+enum class ProfilePhase {
+    HeatFlux,       // Heat source term (HeatSource)
+    Properties,     // Temperature-dependent k, cp, rho
+    Stencil,        // Explicit finite-difference update
+    Accumulators,   // T_max and cooling accumulators
+    Zones,          // Fusion/HAZ zones and melt pool
+    Monitoring,     // Probe sampling
+    FrameExport,    // Video frame CSV
+    Snapshot,       // Snapshot exportResults
+    Checkpoint,     // Checkpoint state copy
+    Count
+};
+
+const char* profilePhaseName(ProfilePhase phase);
+
+// Aggregate of one phase over all threads
+struct PhaseSummary {
+    ProfilePhase phase;
+    std::uint64_t count = 0;
+    double total = 0.0;     // s
+    double min = 0.0;       // s
+    double max = 0.0;       // s
+    double p99 = 0.0;       // s, from the retained samples
+};
+
+// Counter totals of one phase, per thread of the OpenMP team
+struct PhaseCounters {
+    ProfilePhase phase;
+    std::vector<double> values;   // [thread * PerfCounters::EVENTS + event]
+};
+
+// Collects scoped phase timings from every thread while active.
+//
+// Each thread appends to its own buffer (registered once under a mutex),
+// so recording is lock-free. Count, total, min and max cover every scope;
+// individual samples, used for p99 and the trace, are kept up to
+// MAX_SAMPLES_PER_THREAD per thread. Start and stop the profiler while no
+// instrumented code is running.
+//
+// With enableCounters() the scopes also read the performance counters of
+// every OpenMP thread on entry and exit. Counters assume a single
+// instrumented simulation (the scope's thread drives the team); threads
+// waiting at a barrier still spin and count cycles and instructions.
+class Profiler {
+public:
+    static const size_t MAX_SAMPLES_PER_THREAD = 4000000;
+
+    static Profiler& instance();
+
+    // Discard earlier data and start recording
+    void start();
+
+    // Stop recording; closes the performance counters
+    void stop();
+
+    bool active() const { return active_.load(std::memory_order_relaxed); }
+
+    // Open performance counters on `threads` OpenMP threads and measure the
+    // memory bandwidth ceiling; call before start(). Returns false with the
+    // reason in `error` if no counter is available (timing still works);
+    // otherwise `error` names any missing events.
+    bool enableCounters(int threads, std::string& error);
+
+    bool countersActive() const { return counters_active_.load(std::memory_order_relaxed); }
+
+    // Counter snapshot at phase entry and accumulation at exit
+    void beginCounters(ProfilePhase phase);
+    void endCounters(ProfilePhase phase);
+
+    // Per-phase counter totals (phases never entered omitted)
+    std::vector<PhaseCounters> counterSummary() const;
+
+    // Roofline-style table: cycles, IPC, LLC misses and the estimated DRAM
+    // bandwidth of each phase against the measured ceiling. Prints nothing
+    // unless counters were enabled.
+    void printCounterSummary(std::ostream& out) const;
+
+    // Monotonic clock in ns since the process started profiling
+    static std::int64_t now();
+
+    void record(ProfilePhase phase, std::int64_t start_ns, std::int64_t end_ns);
+
+    // Per-phase aggregates, phases without samples omitted. Without
+    // percentiles p99 stays 0 and the samples are not scanned, which is
+    // cheap enough to call while the run is in progress.
+    std::vector<PhaseSummary> summary(bool percentiles = true) const;
+
+    // Seconds between start() and stop() (or now, while active)
+    double elapsed() const;
+
+    // Samples beyond the per-thread limit (counted, but not in p99 or trace)
+    std::uint64_t droppedSamples() const;
+
+    // JSON report: elapsed time and count/total/mean/min/max/p99 per phase,
+    // plus per-thread counters when enabled. Throws std::runtime_error on
+    // I/O errors.
+    void writeReport(const std::string& filename) const;
+
+    // Chrome trace-event file ("X" events, one track per thread), viewable
+    // in chrome://tracing or Perfetto. Throws std::runtime_error on I/O errors.
+    void writeTrace(const std::string& filename) const;
+
+private:
+    struct Sample {
+        std::int64_t start;
+        std::int64_t duration;
+        ProfilePhase phase;
+    };
+
+    struct PhaseTotals {
+        std::uint64_t count = 0;
+        std::int64_t total = 0;
+        std::int64_t min = 0;
+        std::int64_t max = 0;
+    };
+
+    struct ThreadBuffer {
+        int id = 0;
+        std::vector<Sample> samples;
+        PhaseTotals totals[static_cast<int>(ProfilePhase::Count)];
+        std::uint64_t dropped = 0;
+    };
+
+    Profiler() = default;
+
+    ThreadBuffer& threadBuffer();
+
+    std::atomic<bool> active_{false};
+    std::int64_t start_ns_ = 0;
+    std::int64_t stop_ns_ = 0;
+
+    // Performance counters (driven by one thread at a time)
+    PerfCounters counters_;
+    std::atomic<bool> counters_enabled_{false};   // Opened for the next start()
+    std::atomic<bool> counters_active_{false};
+    bool counter_events_[PerfCounters::EVENTS] = {};
+    int counter_threads_ = 0;                      // Non-zero once counters were collected
+    double peak_bandwidth_ = 0.0;                  // bytes/s
+    std::vector<double> counter_scratch_;
+    std::vector<double> counter_begin_[static_cast<int>(ProfilePhase::Count)];
+    std::vector<double> counter_total_[static_cast<int>(ProfilePhase::Count)];
+
+    mutable std::mutex mutex_;   // Guards buffers_ (registration and reports)
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+// Times the enclosing scope into the profiler when it is active
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase) : phase_(phase), start_(-1) {
+        Profiler& profiler = Profiler::instance();
+        if (profiler.active()) {
+            if (profiler.countersActive()) {
+                profiler.beginCounters(phase);
+            }
+            start_ = Profiler::now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (start_ >= 0) {
+            const std::int64_t end = Profiler::now();
+            Profiler& profiler = Profiler::instance();
+            if (profiler.countersActive()) {
+                profiler.endCounters(phase_);
+            }
+            profiler.record(phase_, start_, end);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfilePhase phase_;
+    std::int64_t start_;
+};
+
+// WELD_PROFILE_SCOPE(Stencil) times the rest of the enclosing block. It
+// expands to nothing unless the solver is built with WELD_ENABLE_PROFILING
+// (cmake -DWELD_ENABLE_PROFILING=ON, make PROFILE=1).
+#ifdef WELD_ENABLE_PROFILING
+#define WELD_PROFILE_CONCAT_INNER(a, b) a##b
+#define WELD_PROFILE_CONCAT(a, b) WELD_PROFILE_CONCAT_INNER(a, b)
+#define WELD_PROFILE_SCOPE(phase) \
+    ProfileScope WELD_PROFILE_CONCAT(weld_profile_scope_, __LINE__)(ProfilePhase::phase)
+const bool PROFILING_COMPILED = true;
+#else
+#define WELD_PROFILE_SCOPE(phase) ((void)0)
+const bool PROFILING_COMPILED = false;
+#endif
+
+#endif // PROFILER_H
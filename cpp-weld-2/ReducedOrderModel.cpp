@@ -0,0 +1,562 @@
+#include "ReducedOrderModel.h"
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+const char ROM_MAGIC[8] = {'W', 'E', 'L', 'D', 'R', 'O', 'M', 'S'};
+const std::uint32_t ROM_VERSION = 1;
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeArray(std::ofstream& out, const std::vector<T>& data) {
+    std::uint64_t n = data.size();
+    writeValue(out, n);
+    out.write(reinterpret_cast<const char*>(data.data()), n * sizeof(T));
+}
+
+void writeString(std::ofstream& out, const std::string& s) {
+    std::uint64_t n = s.size();
+    writeValue(out, n);
+    out.write(s.data(), n);
+}
+
+template <typename T>
+void readValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void readArray(std::ifstream& in, std::vector<T>& data) {
+    std::uint64_t n = 0;
+    readValue(in, n);
+    if (!in || n > (1ull << 40)) {
+        throw std::runtime_error("corrupt array length");
+    }
+    data.resize(n);
+    in.read(reinterpret_cast<char*>(data.data()), n * sizeof(T));
+}
+
+void readString(std::ifstream& in, std::string& s) {
+    std::uint64_t n = 0;
+    readValue(in, n);
+    if (!in || n > (1ull << 20)) {
+        throw std::runtime_error("corrupt string length");
+    }
+    s.resize(n);
+    in.read(&s[0], n);
+}
+
+// Eigen-decomposition of the symmetric n x n matrix A (row-major) by cyclic
+// Jacobi rotations. Eigenvalues are returned in descending order with the
+// matching eigenvectors as the columns of V.
+void symmetricEigen(std::vector<double> A, int n, std::vector<double>& values, std::vector<double>& V) {
+    V.assign(static_cast<size_t>(n) * n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        V[i * n + i] = 1.0;
+    }
+
+    for (int sweep = 0; sweep < 100; ++sweep) {
+        double off = 0.0, total = 0.0;
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                total += A[i * n + j] * A[i * n + j];
+                if (i != j) {
+                    off += A[i * n + j] * A[i * n + j];
+                }
+            }
+        }
+        if (off <= 1e-30 * total) {
+            break;
+        }
+
+        for (int p = 0; p < n - 1; ++p) {
+            for (int q = p + 1; q < n; ++q) {
+                const double apq = A[p * n + q];
+                if (apq == 0.0) {
+                    continue;
+                }
+                const double theta = (A[q * n + q] - A[p * n + p]) / (2.0 * apq);
+                const double t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+
+                for (int k = 0; k < n; ++k) {
+                    const double akp = A[k * n + p], akq = A[k * n + q];
+                    A[k * n + p] = c * akp - s * akq;
+                    A[k * n + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; ++k) {
+                    const double apk = A[p * n + k], aqk = A[q * n + k];
+                    A[p * n + k] = c * apk - s * aqk;
+                    A[q * n + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; ++k) {
+                    const double vkp = V[k * n + p], vkq = V[k * n + q];
+                    V[k * n + p] = c * vkp - s * vkq;
+                    V[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return A[a * n + a] > A[b * n + b]; });
+
+    values.resize(n);
+    std::vector<double> sorted(V.size());
+    for (int k = 0; k < n; ++k) {
+        values[k] = A[order[k] * n + order[k]];
+        for (int i = 0; i < n; ++i) {
+            sorted[i * n + k] = V[i * n + order[k]];
+        }
+    }
+    V.swap(sorted);
+}
+
+// Solve A X = B for the n x n matrix A and n x m right-hand sides B (both
+// row-major, overwritten) by Gaussian elimination with partial pivoting
+void solveLinear(std::vector<double>& A, std::vector<double>& B, int n, int m) {
+    for (int col = 0; col < n; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < n; ++r) {
+            if (std::fabs(A[r * n + col]) > std::fabs(A[pivot * n + col])) {
+                pivot = r;
+            }
+        }
+        if (std::fabs(A[pivot * n + col]) < 1e-300) {
+            throw std::invalid_argument("singular interpolation system (repeated training points?)");
+        }
+        if (pivot != col) {
+            for (int k = 0; k < n; ++k) {
+                std::swap(A[col * n + k], A[pivot * n + k]);
+            }
+            for (int k = 0; k < m; ++k) {
+                std::swap(B[col * m + k], B[pivot * m + k]);
+            }
+        }
+        for (int r = col + 1; r < n; ++r) {
+            const double f = A[r * n + col] / A[col * n + col];
+            if (f == 0.0) {
+                continue;
+            }
+            for (int k = col; k < n; ++k) {
+                A[r * n + k] -= f * A[col * n + k];
+            }
+            for (int k = 0; k < m; ++k) {
+                B[r * m + k] -= f * B[col * m + k];
+            }
+        }
+    }
+    for (int r = n - 1; r >= 0; --r) {
+        for (int k = 0; k < m; ++k) {
+            double sum = B[r * m + k];
+            for (int c = r + 1; c < n; ++c) {
+                sum -= A[r * n + c] * B[c * m + k];
+            }
+            B[r * m + k] = sum / A[r * n + r];
+        }
+    }
+}
+
+double cubicKernel(const std::vector<double>& a, const std::vector<double>& b) {
+    double r2 = 0.0;
+    for (size_t k = 0; k < a.size(); ++k) {
+        r2 += (a[k] - b[k]) * (a[k] - b[k]);
+    }
+    return r2 * std::sqrt(r2);
+}
+
+} // namespace
+
+std::vector<double> ReducedOrderModel::scaled(const std::vector<double>& params) const {
+    std::vector<double> s(params.size());
+    for (size_t k = 0; k < params.size(); ++k) {
+        const double range = upper_[k] - lower_[k];
+        s[k] = range > 0 ? (params[k] - lower_[k]) / range : 0.0;
+    }
+    return s;
+}
+
+void ReducedOrderModel::build(const std::vector<std::string>& names,
+                              const std::vector<std::vector<double>>& params,
+                              const std::vector<std::vector<double>>& snapshots,
+                              const SimulationConfig& base, double energy) {
+    const int runs = static_cast<int>(params.size());
+    const int d = static_cast<int>(names.size());
+    const size_t N = static_cast<size_t>(base.nx) * base.ny;
+
+    if (runs < d + 2) {
+        throw std::invalid_argument("need at least " + std::to_string(d + 2) +
+                                    " training runs for " + std::to_string(d) + " parameters");
+    }
+    if (static_cast<int>(snapshots.size()) != runs) {
+        throw std::invalid_argument("one snapshot per training run is required");
+    }
+    for (int r = 0; r < runs; ++r) {
+        if (static_cast<int>(params[r].size()) != d || snapshots[r].size() != N) {
+            throw std::invalid_argument("training run " + std::to_string(r + 1) + " does not match the grid");
+        }
+    }
+
+    names_ = names;
+    nx_ = base.nx;
+    ny_ = base.ny;
+    Lx_ = base.Lx;
+    Ly_ = base.Ly;
+    T_melt_ = (base.mat_1_T_melt + base.mat_2_T_melt) / 2.0;
+    T_crit_ = (base.mat_1_T_crit + base.mat_2_T_crit) / 2.0;
+
+    lower_ = params[0];
+    upper_ = params[0];
+    for (const auto& p : params) {
+        for (int k = 0; k < d; ++k) {
+            lower_[k] = std::min(lower_[k], p[k]);
+            upper_[k] = std::max(upper_[k], p[k]);
+        }
+    }
+
+    // Mean map and the Gram matrix of the centred snapshots
+    mean_.assign(N, 0.0);
+    for (const auto& s : snapshots) {
+        for (size_t c = 0; c < N; ++c) {
+            mean_[c] += s[c] / runs;
+        }
+    }
+
+    std::vector<double> gram(static_cast<size_t>(runs) * runs, 0.0);
+    for (int a = 0; a < runs; ++a) {
+        for (int b = a; b < runs; ++b) {
+            double sum = 0.0;
+            for (size_t c = 0; c < N; ++c) {
+                sum += (snapshots[a][c] - mean_[c]) * (snapshots[b][c] - mean_[c]);
+            }
+            gram[a * runs + b] = gram[b * runs + a] = sum;
+        }
+    }
+
+    std::vector<double> lambda, V;
+    symmetricEigen(gram, runs, lambda, V);
+
+    // Fewest modes reaching the energy fraction; negligible modes are noise
+    double total = 0.0;
+    for (double l : lambda) {
+        total += std::max(0.0, l);
+    }
+    rank_ = 0;
+    double kept = 0.0;
+    while (rank_ < runs && total > 0 && lambda[rank_] > 1e-12 * lambda[0] && kept < energy * total) {
+        kept += lambda[rank_];
+        ++rank_;
+    }
+    captured_energy_ = total > 0 ? kept / total : 1.0;
+
+    // Modes phi_k = sum_j V[j][k] (s_j - mean) / sqrt(lambda_k), and the
+    // training coefficients sqrt(lambda_k) V[j][k]
+    modes_.assign(static_cast<size_t>(rank_) * N, 0.0);
+    for (int k = 0; k < rank_; ++k) {
+        const double scale = 1.0 / std::sqrt(lambda[k]);
+        double* mode = modes_.data() + static_cast<size_t>(k) * N;
+        for (int j = 0; j < runs; ++j) {
+            const double w = V[j * runs + k] * scale;
+            for (size_t c = 0; c < N; ++c) {
+                mode[c] += w * (snapshots[j][c] - mean_[c]);
+            }
+        }
+    }
+
+    // Cubic RBF with a linear polynomial tail, one right-hand side per mode:
+    //   [ Phi  P ] [w]   [coeff]
+    //   [ P^T  0 ] [c] = [  0  ]
+    centres_.clear();
+    for (const auto& p : params) {
+        centres_.push_back(scaled(p));
+    }
+
+    const int n = runs + d + 1;
+    std::vector<double> A(static_cast<size_t>(n) * n, 0.0);
+    weights_.assign(static_cast<size_t>(n) * rank_, 0.0);
+    for (int a = 0; a < runs; ++a) {
+        for (int b = 0; b < runs; ++b) {
+            A[a * n + b] = cubicKernel(centres_[a], centres_[b]);
+        }
+        A[a * n + runs] = A[runs * n + a] = 1.0;
+        for (int k = 0; k < d; ++k) {
+            A[a * n + runs + 1 + k] = A[(runs + 1 + k) * n + a] = centres_[a][k];
+        }
+        for (int k = 0; k < rank_; ++k) {
+            weights_[a * rank_ + k] = std::sqrt(lambda[k]) * V[a * runs + k];
+        }
+    }
+    if (rank_ > 0) {
+        solveLinear(A, weights_, n, rank_);
+    }
+}
+
+bool ReducedOrderModel::inTrainingRange(const std::vector<double>& params) const {
+    for (size_t k = 0; k < params.size() && k < lower_.size(); ++k) {
+        if (params[k] < lower_[k] || params[k] > upper_[k]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RomPrediction ReducedOrderModel::predict(const std::vector<double>& params) const {
+    if (params.size() != names_.size()) {
+        throw std::invalid_argument("expected " + std::to_string(names_.size()) + " parameter values");
+    }
+
+    const int runs = trainingRuns();
+    const int d = static_cast<int>(names_.size());
+    const std::vector<double> s = scaled(params);
+
+    // Reduced coefficients
+    std::vector<double> coeff(rank_, 0.0);
+    for (int j = 0; j < runs; ++j) {
+        const double phi = cubicKernel(s, centres_[j]);
+        for (int k = 0; k < rank_; ++k) {
+            coeff[k] += phi * weights_[j * rank_ + k];
+        }
+    }
+    for (int k = 0; k < rank_; ++k) {
+        coeff[k] += weights_[runs * rank_ + k];
+        for (int l = 0; l < d; ++l) {
+            coeff[k] += s[l] * weights_[(runs + 1 + l) * rank_ + k];
+        }
+    }
+
+    RomPrediction out;
+    out.T_max = mean_;
+    const size_t N = mean_.size();
+    for (int k = 0; k < rank_; ++k) {
+        const double* mode = modes_.data() + static_cast<size_t>(k) * N;
+        const double c = coeff[k];
+        for (size_t cell = 0; cell < N; ++cell) {
+            out.T_max[cell] += c * mode[cell];
+        }
+    }
+
+    size_t fusion = 0, haz = 0;
+    out.T_peak = out.T_max.empty() ? 0.0 : out.T_max[0];
+    for (double T : out.T_max) {
+        out.T_peak = std::max(out.T_peak, T);
+        if (T >= T_melt_) {
+            ++fusion;
+        } else if (T >= T_crit_) {
+            ++haz;
+        }
+    }
+    const double cell_area = Lx_ / (nx_ - 1) * Ly_ / (ny_ - 1);
+    out.fusion_area = fusion * cell_area;
+    out.HAZ_area = haz * cell_area;
+    return out;
+}
+
+void ReducedOrderModel::save(const std::string& filename) const {
+    const std::string tmp_name = filename + ".tmp";
+    std::ofstream out(tmp_name, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not open model file " + tmp_name);
+    }
+
+    out.write(ROM_MAGIC, sizeof(ROM_MAGIC));
+    writeValue(out, ROM_VERSION);
+    writeValue(out, static_cast<std::uint64_t>(names_.size()));
+    for (const auto& name : names_) {
+        writeString(out, name);
+    }
+    writeArray(out, lower_);
+    writeArray(out, upper_);
+    writeValue(out, nx_);
+    writeValue(out, ny_);
+    writeValue(out, Lx_);
+    writeValue(out, Ly_);
+    writeValue(out, T_melt_);
+    writeValue(out, T_crit_);
+    writeValue(out, rank_);
+    writeValue(out, captured_energy_);
+    writeArray(out, mean_);
+    writeArray(out, modes_);
+    writeValue(out, static_cast<std::uint64_t>(centres_.size()));
+    for (const auto& c : centres_) {
+        writeArray(out, c);
+    }
+    writeArray(out, weights_);
+
+    out.close();
+    if (!out || std::rename(tmp_name.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp_name.c_str());
+        throw std::runtime_error("Failed while writing model " + filename);
+    }
+}
+
+void ReducedOrderModel::load(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Could not open model file " + filename);
+    }
+
+    char magic[sizeof(ROM_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, ROM_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error(filename + " is not a reduced-order model");
+    }
+    std::uint32_t version = 0;
+    readValue(in, version);
+    if (version != ROM_VERSION) {
+        throw std::runtime_error("Unsupported model version " + std::to_string(version) +
+                                 " in " + filename);
+    }
+
+    try {
+        std::uint64_t count = 0;
+        readValue(in, count);
+        if (!in || count > 1024) {
+            throw std::runtime_error("corrupt parameter count");
+        }
+        names_.resize(count);
+        for (auto& name : names_) {
+            readString(in, name);
+        }
+        readArray(in, lower_);
+        readArray(in, upper_);
+        readValue(in, nx_);
+        readValue(in, ny_);
+        readValue(in, Lx_);
+        readValue(in, Ly_);
+        readValue(in, T_melt_);
+        readValue(in, T_crit_);
+        readValue(in, rank_);
+        readValue(in, captured_energy_);
+        readArray(in, mean_);
+        readArray(in, modes_);
+        readValue(in, count);
+        if (!in || count > (1ull << 24)) {
+            throw std::runtime_error("corrupt run count");
+        }
+        centres_.resize(count);
+        for (auto& c : centres_) {
+            readArray(in, c);
+        }
+        readArray(in, weights_);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Truncated model " + filename + " (" + e.what() + ")");
+    }
+
+    const size_t N = static_cast<size_t>(nx_) * ny_;
+    if (!in || mean_.size() != N || modes_.size() != N * rank_ ||
+        weights_.size() != (centres_.size() + names_.size() + 1) * rank_) {
+        throw std::runtime_error("Truncated model " + filename);
+    }
+}
+
+ReducedOrderModel trainReducedOrderModel(const SweepDesign& design, int holdout, int jobs,
+                                         std::vector<RomValidation>& validation) {
+    // Every run must share the grid and zone thresholds of the base case
+    static const char* const fixed[] = {
+        "Lx", "Ly", "nx", "ny",
+        "material_1.T_melt", "material_1.T_crit", "material_2.T_melt", "material_2.T_crit",
+    };
+    std::vector<std::string> names;
+    for (const auto& p : design.parameters) {
+        for (const char* f : fixed) {
+            if (p.name == f) {
+                throw std::runtime_error("parameter '" + p.name + "' cannot vary in a reduced-order model");
+            }
+        }
+        names.push_back(p.name);
+    }
+
+    const int n = static_cast<int>(sweepPoints(design).size());
+    std::vector<std::vector<double>> snapshots(n);
+    std::vector<SweepResult> results = runSweep(design, jobs, [&](int run, const WeldingSimulation& sim) {
+        snapshots[run] = sim.peakTemperature();
+    });
+    for (int r = 0; r < n; ++r) {
+        if (!results[r].ok) {
+            throw std::runtime_error("training run " + std::to_string(r + 1) + " failed: " + results[r].error);
+        }
+    }
+
+    // Held-out runs spread evenly through the design
+    std::vector<bool> held(n, false);
+    if (holdout < 0) {
+        holdout = n / 5;
+    }
+    holdout = std::min(holdout, n);
+    for (int h = 0; h < holdout; ++h) {
+        held[static_cast<int>((h + 0.5) * n / holdout)] = true;
+    }
+
+    std::vector<std::vector<double>> train_params, train_snapshots;
+    for (int r = 0; r < n; ++r) {
+        if (!held[r]) {
+            train_params.push_back(results[r].values);
+            train_snapshots.push_back(std::move(snapshots[r]));
+        }
+    }
+
+    ReducedOrderModel model;
+    try {
+        model.build(names, train_params, train_snapshots, design.base);
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error(e.what());
+    }
+
+    validation.clear();
+    for (int r = 0; r < n; ++r) {
+        if (!held[r]) {
+            continue;
+        }
+        RomValidation v;
+        v.run = r + 1;
+        v.values = results[r].values;
+        v.full = results[r].stats;
+        v.rom = model.predict(v.values);
+
+        double sum = 0.0;
+        for (size_t c = 0; c < snapshots[r].size(); ++c) {
+            const double e = v.rom.T_max[c] - snapshots[r][c];
+            sum += e * e;
+            v.max_error = std::max(v.max_error, std::fabs(e));
+        }
+        v.rms_error = std::sqrt(sum / snapshots[r].size());
+        validation.push_back(std::move(v));
+    }
+    return model;
+}
+
+void writeRomValidation(std::ostream& out, const ReducedOrderModel& model,
+                        const std::vector<RomValidation>& validation) {
+    out << "run";
+    for (const auto& name : model.parameterNames()) {
+        out << "," << name;
+    }
+    out << ",T_peak_full,T_peak_rom,fusion_area_mm2_full,fusion_area_mm2_rom,"
+        << "HAZ_area_mm2_full,HAZ_area_mm2_rom,T_max_rms_error,T_max_max_error" << std::endl;
+
+    out << std::setprecision(10);
+    for (size_t r = 0; r < validation.size(); ++r) {
+        const RomValidation& v = validation[r];
+        out << v.run;
+        for (double x : v.values) {
+            out << "," << x;
+        }
+        out << "," << v.full.T_peak << "," << v.rom.T_peak
+            << "," << v.full.fusion_area * 1e6 << "," << v.rom.fusion_area * 1e6
+            << "," << v.full.HAZ_area * 1e6 << "," << v.rom.HAZ_area * 1e6
+            << "," << v.rms_error << "," << v.max_error << std::endl;
+    }
+}
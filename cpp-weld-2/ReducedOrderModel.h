@@ -0,0 +1,98 @@
+#ifndef REDUCED_ORDER_MODEL_H
+#define REDUCED_ORDER_MODEL_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "WeldingSimulation.h"
+#include "Sweep.h"
+
+// Surrogate output for one parameter point
+struct RomPrediction {
+    std::vector<double> T_max;   // Peak temperature map (row-major, K)
+    double T_peak = 0.0;         // K
+    double fusion_area = 0.0;    // m²
+    double HAZ_area = 0.0;       // m²
+};
+
+// Reduced-order model of the peak temperature map.
+//
+// The training maps are centred on their mean and compressed by proper
+// orthogonal decomposition (method of snapshots: eigenvectors of the run-by-
+// run Gram matrix). Each retained mode's coefficient is interpolated over the
+// parameter box with a cubic radial basis function plus a linear term, so a
+// prediction costs one small RBF sum and a rank-r combination of modes.
+class ReducedOrderModel {
+public:
+    // Build from training runs: params[run][parameter] and the run's T_max
+    // map. Keeps the fewest modes holding `energy` of the snapshot variance.
+    // `base` supplies the grid and the fusion/HAZ thresholds.
+    // Throws std::invalid_argument on inconsistent input.
+    void build(const std::vector<std::string>& names,
+               const std::vector<std::vector<double>>& params,
+               const std::vector<std::vector<double>>& snapshots,
+               const SimulationConfig& base, double energy = 0.99999);
+
+    // Throws std::invalid_argument if params has the wrong size
+    RomPrediction predict(const std::vector<double>& params) const;
+
+    // Whether params lies inside the training box (outside is extrapolation)
+    bool inTrainingRange(const std::vector<double>& params) const;
+
+    // Binary model file. Throw std::runtime_error on I/O errors.
+    void save(const std::string& filename) const;
+    void load(const std::string& filename);
+
+    const std::vector<std::string>& parameterNames() const { return names_; }
+    int rank() const { return rank_; }
+    int trainingRuns() const { return static_cast<int>(centres_.size()); }
+    double capturedEnergy() const { return captured_energy_; }
+
+    // Grid the maps are defined on
+    int nx() const { return nx_; }
+    int ny() const { return ny_; }
+    double Lx() const { return Lx_; }
+    double Ly() const { return Ly_; }
+
+private:
+    std::vector<std::string> names_;
+    std::vector<double> lower_, upper_;         // Training box per parameter
+
+    int nx_ = 0, ny_ = 0;
+    double Lx_ = 0.0, Ly_ = 0.0;
+    double T_melt_ = 0.0, T_crit_ = 0.0;
+
+    int rank_ = 0;
+    double captured_energy_ = 0.0;
+    std::vector<double> mean_;                  // Mean map (N)
+    std::vector<double> modes_;                 // Mode-major: modes_[k * N + cell]
+
+    std::vector<std::vector<double>> centres_;  // Training points scaled to [0, 1]
+    std::vector<double> weights_;               // (runs + parameters + 1) x rank, row-major
+
+    std::vector<double> scaled(const std::vector<double>& params) const;
+};
+
+// Held-out comparison of one full run with the model
+struct RomValidation {
+    int run = 0;                  // Design run (1-based)
+    std::vector<double> values;   // Parameter values
+    SimulationStatistics full;    // Full simulation
+    RomPrediction rom;            // Surrogate
+    double rms_error = 0.0;       // RMS of the T_max map difference (K)
+    double max_error = 0.0;       // Largest |T_max difference| (K)
+};
+
+// Run the sweep design, build a model from all but `holdout` runs (spread
+// evenly through the design; negative = 20% of the runs) and compare it with
+// the held-out full runs.
+// Throws std::runtime_error if a run fails or too few runs remain.
+ReducedOrderModel trainReducedOrderModel(const SweepDesign& design, int holdout, int jobs,
+                                         std::vector<RomValidation>& validation);
+
+// Validation table: one row per held-out run
+void writeRomValidation(std::ostream& out, const ReducedOrderModel& model,
+                        const std::vector<RomValidation>& validation);
+
+#endif // REDUCED_ORDER_MODEL_H
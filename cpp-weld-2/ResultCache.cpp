@@ -0,0 +1,121 @@
+#include "ResultCache.h"
+#include <filesystem>
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* const ENTRY_EXTENSION = ".result";
+
+} // namespace
+
+ResultCache::ResultCache(const std::string& directory, double max_mb)
+    : directory_(directory),
+      max_bytes_(static_cast<std::uintmax_t>(std::max(0.0, max_mb) * 1024.0 * 1024.0)) {}
+
+bool ResultCache::cacheable(const SimulationConfig& config) {
+    return !config.save_video_frames && config.snapshot_time <= 0 &&
+           config.history_chunk_rows <= 0 && config.restart_file.empty() && config.telemetry_path.empty();
+}
+
+std::string ResultCache::key(const SimulationConfig& config) {
+    std::uint64_t hash = 14695981039346656037ull;
+    const std::string text = canonicalConfig(config) + ";solver=" + SOLVER_VERSION;
+    for (unsigned char ch : text) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return os.str();
+}
+
+std::string ResultCache::entryPath(const SimulationConfig& config) const {
+    return directory_ + "/" + key(config) + ENTRY_EXTENSION;
+}
+
+bool ResultCache::load(const SimulationConfig& config, CheckpointState& state) const {
+    const std::string path = entryPath(config);
+    std::error_code ec;
+    if (!fs::exists(path, ec)) {
+        return false;
+    }
+
+    try {
+        state = readCheckpointFile(path);
+    } catch (const std::exception&) {
+        fs::remove(path, ec);
+        return false;
+    }
+
+    // The entry name covers the solver version; the stored hash guards
+    // against a collision of the two independent hashes
+    if (state.config_hash != configHash(config)) {
+        return false;
+    }
+
+    // Mark as recently used
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void ResultCache::store(const SimulationConfig& config, const CheckpointState& state) const {
+    fs::create_directories(directory_);
+
+    // Unique staging name so concurrent writers of the same entry never collide
+    std::random_device rd;
+    std::ostringstream staging;
+    staging << entryPath(config) << "." << std::hex << rd() << rd() << ".part";
+
+    writeCheckpointFile(staging.str(), state);
+
+    std::error_code ec;
+    fs::rename(staging.str(), entryPath(config), ec);
+    if (ec) {
+        fs::remove(staging.str(), ec);
+        throw std::runtime_error("Could not store cache entry in " + directory_);
+    }
+
+    evict();
+}
+
+void ResultCache::evict() const {
+    struct Entry {
+        fs::path path;
+        std::uintmax_t size;
+        fs::file_time_type used;
+    };
+
+    std::error_code ec;
+    std::vector<Entry> entries;
+    std::uintmax_t total = 0;
+    for (const auto& item : fs::directory_iterator(directory_, ec)) {
+        if (item.path().extension() != ENTRY_EXTENSION) {
+            continue;
+        }
+        Entry e{item.path(), item.file_size(ec), item.last_write_time(ec)};
+        if (ec) {
+            continue;  // Removed by another process meanwhile
+        }
+        total += e.size;
+        entries.push_back(e);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.used < b.used; });
+
+    // Oldest first; the newest entry is always kept
+    for (size_t k = 0; k + 1 < entries.size() && total > max_bytes_; ++k) {
+        if (fs::remove(entries[k].path, ec)) {
+            total -= entries[k].size;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <string>
+#include <cstdint>
+
+#include "Checkpoint.h"
+#include "WeldingSimulation.h"
+
+// Content-addressed store of finished runs.
+//
+// An entry is the final solver state (checkpoint format) of a completed run,
+// named by a hash of canonicalConfig() and SOLVER_VERSION. Restoring it
+// gives back T_final, T_max, the cooling accumulators, zones, melt pool
+// series and thermal history, so every output file and statistic can be
+// produced without time stepping. Loading an entry refreshes its timestamp;
+// when the directory grows beyond its size limit the least recently used
+// entries are deleted. Entries are written under a unique name and renamed
+// into place, so concurrent runs sharing a directory never read partial files.
+class ResultCache {
+public:
+    ResultCache(const std::string& directory, double max_mb);
+
+    // Runs with outputs produced during time stepping (video frames,
+    // snapshots, streamed history, live telemetry) or resuming a checkpoint
+    // are not cached
+    static bool cacheable(const SimulationConfig& config);
+
+    // Entry name for config (16 hex digits)
+    static std::string key(const SimulationConfig& config);
+
+    // Load the final state of an identical earlier run. Returns false on a
+    // miss; unreadable entries are deleted and count as misses.
+    bool load(const SimulationConfig& config, CheckpointState& state) const;
+
+    // Store the final state of a run, then evict down to the size limit.
+    // Throws std::runtime_error on I/O failure.
+    void store(const SimulationConfig& config, const CheckpointState& state) const;
+
+    // Delete least recently used entries until the total size fits
+    void evict() const;
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string directory_;
+    std::uintmax_t max_bytes_;
+
+    std::string entryPath(const SimulationConfig& config) const;
+};
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,43 @@
+#ifndef ROSENTHAL_H
+#define ROSENTHAL_H
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "WeldingSimulation.h"
+
+// Quasi-steady Rosenthal solution for a line source moving through a thin
+// plate (heat flows in the plane only, infinite plate, constant properties):
+//
+//   T - T0 = Q / (2 pi k d) * exp(-lambda xi) * K0(lambda r),  lambda = v / (2 alpha)
+//
+// with xi the distance ahead of the source along the weld and r the distance
+// from it. Q is the absorbed power (W) and d the plate thickness.
+// runAnalytic() takes Q from the heat source of weld_process (HeatSource.h).
+double rosenthalTemperature(double Q, double v, double thickness, double k, double alpha,
+                            double T0, double xi, double eta);
+
+// Analytic field over the simulation grid
+struct AnalyticResult {
+    std::vector<double> T;        // Field with the arc at its last position on the plate
+    std::vector<double> T_max;    // Peak temperature as the arc travelled its path
+    SimulationStatistics stats;   // T_peak, zone areas and centreline t8/5 per material
+    double x_arc = 0.0;           // Last arc position (m)
+    double y_arc = 0.0;
+};
+
+// Evaluate the Rosenthal solution on the grid of config in one parallel
+// pass. Each cell uses the room-temperature properties of its material.
+// T_max at a cell is the peak of the quasi-steady field along its line
+// parallel to the weld, restricted to the part of the path the arc covered
+// (x_start to the plate edge or t_end). The field is singular on the source
+// line, so temperatures are capped at 5000 K like the numerical solver.
+AnalyticResult runAnalytic(const SimulationConfig& config,
+                           std::shared_ptr<const SimulationGrid> grid = nullptr);
+
+// Write "i,j,x,y,T,T_max" rows. Throws std::runtime_error on I/O errors.
+void writeAnalyticResults(const std::string& filename, const SimulationGrid& grid,
+                          const AnalyticResult& result);
+
+#endif // ROSENTHAL_H
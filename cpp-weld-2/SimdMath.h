@@ -0,0 +1,54 @@
+#ifndef SIMD_MATH_H
+#define SIMD_MATH_H
+
+#include <cstdint>
+#include <cstring>
+
+// exp(x) in straight-line arithmetic, for loops that must vectorize.
+//
+// std::exp is an opaque libm call that may set errno, so GCC will not
+// vectorize a loop around it, and glibc only declares its vector variants
+// (libmvec) under -ffast-math. This version inlines into the loop body:
+// x = n ln2 + r with |r| <= ln2 / 2, exp(r) as a degree-13 Taylor polynomial
+// and 2^n written into the exponent bits. Adding 1.5 * 2^52 rounds x / ln2
+// to n and leaves n in the low mantissa bits, so no double-to-integer
+// conversion is needed. Within 1 ulp of std::exp for x in [-708, 709]; x is
+// clamped to that range, so exp(-708) ~ 3e-308 stands in for underflow.
+inline double simdExp(double x) {
+    const double LOG2E = 1.4426950408889634;
+    const double LN2_HI = 6.93147180369123816490e-01;
+    const double LN2_LO = 1.90821492927058770002e-10;
+    const double SHIFT = 6755399441055744.0;  // 1.5 * 2^52
+
+    x = (x < -708.0) ? -708.0 : x;
+    x = (x > 709.0) ? 709.0 : x;
+
+    const double kd = x * LOG2E + SHIFT;
+    std::uint64_t bits;
+    std::memcpy(&bits, &kd, sizeof bits);
+    const double n = kd - SHIFT;
+    const double r = (x - n * LN2_HI) - n * LN2_LO;
+
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    // Low 12 bits of bits + 1023 are the biased exponent n + 1023
+    const std::uint64_t scale_bits = (bits + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &scale_bits, sizeof scale);
+    return p * scale;
+}
+
+#endif // SIMD_MATH_H
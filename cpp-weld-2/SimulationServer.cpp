@@ -0,0 +1,530 @@
+#include "SimulationServer.h"
+#include "BatchRunner.h"
+#include "CommandLine.h"
+#include "ConfigLoader.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <omp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// How often blocked accept/read loops check for shutdown (ms)
+const int POLL_INTERVAL_MS = 200;
+
+volatile std::sig_atomic_t signal_received = 0;
+
+void onSignal(int) {
+    signal_received = 1;
+}
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Invalid socket path '" + path + "'");
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+// Connected stream socket, or -1 (errno set)
+int connectTo(const std::string& path) {
+    sockaddr_un address = socketAddress(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+// Write all of text; false if the peer has gone
+bool sendAll(int fd, const std::string& text) {
+    size_t sent = 0;
+    while (sent < text.size()) {
+        ssize_t n = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::string jsonLine(const JsonValue& value) {
+    std::ostringstream out;
+    writeJson(out, value, JSON_COMPACT);
+    out << '\n';
+    return out.str();
+}
+
+JsonValue errorReply(const JsonValue* id, const std::string& message) {
+    JsonValue reply = JsonValue::makeObject();
+    if (id) {
+        reply.set("id", *id);
+    }
+    reply.set("ok", JsonValue::makeBool(false));
+    reply.set("error", JsonValue::makeString(message));
+    return reply;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// One client; jobs from it may still be running after it stops sending
+struct SimulationServer::Connection {
+    int fd = -1;
+    std::mutex write_mutex;
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    int outstanding = 0;
+
+    void reply(const JsonValue& value) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        sendAll(fd, jsonLine(value));   // A client that left just misses its reply
+    }
+};
+
+SimulationServer::SimulationServer(const ServerOptions& options, const SimulationConfig& base)
+    : options_(options), base_(base), max_threads_(omp_get_max_threads()) {
+    options_.workers = std::max(1, options_.workers);
+    socketAddress(options_.socket_path);   // Validate early
+}
+
+SimulationServer::~SimulationServer() {
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(options_.socket_path.c_str());
+    }
+}
+
+void SimulationServer::bindSocket() {
+    const std::string& path = options_.socket_path;
+
+    // Replace a stale socket from a server that died, but never a live one
+    struct stat info;
+    if (::lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error(path + " exists and is not a socket");
+        }
+        int fd = connectTo(path);
+        if (fd >= 0) {
+            ::close(fd);
+            throw std::runtime_error("A server is already listening on " + path);
+        }
+        ::unlink(path.c_str());
+    }
+
+    sockaddr_un address = socketAddress(path);
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd_, SOMAXCONN) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("Could not listen on " + path + ": " + error);
+    }
+}
+
+void SimulationServer::serve() {
+    bindSocket();
+
+    signal_received = 0;
+    struct sigaction action, old_int, old_term;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &old_int);
+    sigaction(SIGTERM, &action, &old_term);
+
+    pool_ = std::make_unique<ThreadPool>(options_.workers, true);   // Jobs in arrival order
+    std::cout << "Serving on " << options_.socket_path << ": " << options_.workers
+              << " concurrent jobs, " << std::max(1, max_threads_ / options_.workers)
+              << " OpenMP threads each; jobs of " << options_.large_cells
+              << "+ cells run alone" << std::endl;
+
+    while (!stopping_ && !signal_received) {
+        pollfd p = {listen_fd_, POLLIN, 0};
+        if (::poll(&p, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        auto connection = std::make_shared<Connection>();
+        connection->fd = fd;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            ++connections_;
+        }
+        std::thread(&SimulationServer::handleConnection, this, connection).detach();
+    }
+    stopping_ = true;
+
+    // A second signal interrupts the remaining jobs the usual way
+    sigaction(SIGINT, &old_int, nullptr);
+    sigaction(SIGTERM, &old_term, nullptr);
+
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    ::unlink(options_.socket_path.c_str());
+
+    std::cout << "Shutting down; finishing " << (queued_ + running_) << " queued jobs" << std::endl;
+    {
+        std::unique_lock<std::mutex> lock(connections_mutex_);
+        connections_closed_.wait(lock, [this] { return connections_ == 0; });
+    }
+    pool_.reset();
+    std::cout << "Server stopped: " << completed_ << " jobs completed, " << failed_ << " failed" << std::endl;
+}
+
+void SimulationServer::handleConnection(std::shared_ptr<Connection> connection) {
+    std::string buffer;
+    char chunk[4096];
+    bool open = true;
+
+    while (open && !stopping_) {
+        pollfd p = {connection->fd, POLLIN, 0};
+        if (::poll(&p, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        ssize_t n = ::read(connection->fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            open = false;   // Client done sending; its jobs still reply
+            if (!buffer.empty()) {
+                buffer += '\n';
+            }
+        } else {
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+
+        size_t newline;
+        while ((newline = buffer.find('\n')) != std::string::npos) {
+            const std::string line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+
+            JsonValue request;
+            try {
+                request = parseJson(line);
+                if (!request.isObject()) {
+                    throw std::runtime_error("request must be a JSON object");
+                }
+            } catch (const std::exception& e) {
+                connection->reply(errorReply(nullptr, e.what()));
+                continue;
+            }
+
+            const JsonValue* id = request.find("id");
+            const JsonValue* command = request.find("command");
+            if (command) {
+                const std::string name = command->isString() ? command->string : "";
+                if (name == "status" || name == "shutdown") {
+                    JsonValue reply = JsonValue::makeObject();
+                    if (id) {
+                        reply.set("id", *id);
+                    }
+                    reply.set("ok", JsonValue::makeBool(true));
+                    reply.set("status", statusReply());
+                    stopping_ = stopping_ || name == "shutdown";
+                    connection->reply(reply);
+                } else {
+                    connection->reply(errorReply(id, "unknown command (use 'status' or 'shutdown')"));
+                }
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(connection->mutex);
+                ++connection->outstanding;
+            }
+            ++queued_;
+            const auto submitted = std::chrono::steady_clock::now();
+            pool_->submit([this, connection, request, submitted]() {
+                --queued_;
+                connection->reply(runJob(request, secondsSince(submitted)));
+                std::lock_guard<std::mutex> lock(connection->mutex);
+                --connection->outstanding;
+                connection->idle.notify_all();
+            });
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(connection->mutex);
+        connection->idle.wait(lock, [&] { return connection->outstanding == 0; });
+    }
+    ::close(connection->fd);
+
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    if (--connections_ == 0) {
+        connections_closed_.notify_all();
+    }
+}
+
+JsonValue SimulationServer::statusReply() const {
+    JsonValue reply = JsonValue::makeObject();
+    reply.set("workers", JsonValue::makeNumber(options_.workers));
+    reply.set("large_cells", JsonValue::makeNumber(static_cast<double>(options_.large_cells)));
+    reply.set("queued", JsonValue::makeNumber(queued_));
+    reply.set("running", JsonValue::makeNumber(running_));
+    reply.set("completed", JsonValue::makeNumber(static_cast<double>(completed_)));
+    reply.set("failed", JsonValue::makeNumber(static_cast<double>(failed_)));
+    std::lock_guard<std::mutex> lock(grids_mutex_);
+    reply.set("cached_grids", JsonValue::makeNumber(static_cast<double>(grids_.size())));
+    return reply;
+}
+
+bool SimulationServer::claimOutput(const std::string& output_dir) {
+    const std::string key = std::filesystem::path(output_dir).lexically_normal().string();
+    std::lock_guard<std::mutex> lock(outputs_mutex_);
+    return active_outputs_.insert(key).second;
+}
+
+void SimulationServer::releaseOutput(const std::string& output_dir) {
+    const std::string key = std::filesystem::path(output_dir).lexically_normal().string();
+    std::lock_guard<std::mutex> lock(outputs_mutex_);
+    active_outputs_.erase(key);
+}
+
+JsonValue SimulationServer::runJob(const JsonValue& request, double queued_seconds) {
+    const JsonValue* id = request.find("id");
+    const int number = next_job_++;
+    std::string name = "job" + std::to_string(number);
+
+    try {
+        // Configuration: server defaults, then "config", then "options"
+        if (const JsonValue* n = request.find("name")) {
+            if (!n->isString() || n->string.empty() || n->string == "." || n->string == ".." ||
+                n->string.find('/') != std::string::npos) {
+                throw std::runtime_error("name must be a non-empty string without '/', and not '.' or '..'");
+            }
+            name = n->string;
+        }
+
+        SimulationConfig config = base_;
+        config.output_dir.clear();
+        if (const JsonValue* c = request.find("config")) {
+            applyConfigJson(*c, config);
+        }
+        if (const JsonValue* o = request.find("options")) {
+            if (!o->isArray()) {
+                throw std::runtime_error("options must be an array of strings");
+            }
+            std::vector<std::string> tokens;
+            for (const auto& token : o->array) {
+                if (!token.isString()) {
+                    throw std::runtime_error("options must be an array of strings");
+                }
+                tokens.push_back(token.string);
+            }
+            for (size_t i = 0; i < tokens.size(); ++i) {
+                if (!applyConfigOption(tokens, i, config)) {
+                    throw std::runtime_error("unknown option '" + tokens[i] + "'");
+                }
+            }
+        }
+        // A name already in use gets the job number appended; an explicit
+        // output_dir already in use is refused
+        if (config.output_dir.empty()) {
+            config.output_dir = base_.output_dir + "/" + name;
+            if (!claimOutput(config.output_dir)) {
+                name += "-" + std::to_string(number);
+                config.output_dir = base_.output_dir + "/" + name;
+                if (!claimOutput(config.output_dir)) {
+                    throw std::runtime_error("output directory " + config.output_dir + " is in use by another job");
+                }
+            }
+        } else if (!claimOutput(config.output_dir)) {
+            throw std::runtime_error("output directory " + config.output_dir + " is in use by another job");
+        }
+        struct OutputClaim {
+            SimulationServer& server;
+            std::string dir;
+            ~OutputClaim() { server.releaseOutput(dir); }
+        } output_claim{*this, config.output_dir};
+
+        const long cells = static_cast<long>(config.nx) * config.ny;
+        const bool large = cells >= options_.large_cells;
+        const int threads = large ? max_threads_ : std::max(1, max_threads_ / options_.workers);
+
+        const auto admitted = std::chrono::steady_clock::now();
+        enter(large);
+        queued_seconds += secondsSince(admitted);   // Pool queue plus exclusive-job wait
+        ++running_;
+        struct Admission {
+            SimulationServer& server;
+            bool large;
+            ~Admission() {
+                --server.running_;
+                server.leave(large);
+            }
+        } admission{*this, large};
+
+        {
+            std::lock_guard<std::mutex> lock(print_mutex_);
+            std::cout << "[job " << number << "] " << name << " -> " << config.output_dir
+                      << (large ? " (exclusive)" : "") << std::endl;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        omp_set_num_threads(threads);   // Per worker thread
+
+        prepareOutputDirectories(config);
+        std::ofstream log(config.output_dir + "/simulation_log.txt");
+        bool grid_cached = false;
+        auto shared_grid = grid(config, grid_cached);
+
+        WeldingSimulation sim(config, shared_grid, &log);
+        sim.run();
+        sim.exportResults();
+        const SimulationStatistics stats = sim.statistics();
+        const double seconds = secondsSince(start);
+
+        JsonValue files = JsonValue::makeArray();
+        std::vector<std::string> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(config.output_dir)) {
+            if (entry.is_regular_file()) {
+                paths.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+        for (const auto& p : paths) {
+            files.array.push_back(JsonValue::makeString(p));
+        }
+
+        JsonValue s = JsonValue::makeObject();
+        s.set("T_peak", JsonValue::makeNumber(stats.T_peak));
+        s.set("fusion_area_mm2", JsonValue::makeNumber(stats.fusion_area * 1e6));
+        s.set("HAZ_area_mm2", JsonValue::makeNumber(stats.HAZ_area * 1e6));
+        s.set("peak_cooling_rate", JsonValue::makeNumber(stats.peak_cooling_rate));
+        s.set("t85_min", JsonValue::makeNumber(stats.t85_min));
+        s.set("t85_max", JsonValue::makeNumber(stats.t85_max));
+
+        JsonValue reply = JsonValue::makeObject();
+        if (id) {
+            reply.set("id", *id);
+        }
+        reply.set("ok", JsonValue::makeBool(true));
+        reply.set("name", JsonValue::makeString(name));
+        reply.set("output_dir", JsonValue::makeString(config.output_dir));
+        reply.set("statistics", s);
+        reply.set("files", files);
+        reply.set("cells", JsonValue::makeNumber(static_cast<double>(cells)));
+        reply.set("exclusive", JsonValue::makeBool(large));
+        reply.set("threads", JsonValue::makeNumber(threads));
+        reply.set("grid_cached", JsonValue::makeBool(grid_cached));
+        reply.set("queued_seconds", JsonValue::makeNumber(queued_seconds));
+        reply.set("run_seconds", JsonValue::makeNumber(seconds));
+
+        ++completed_;
+        std::lock_guard<std::mutex> lock(print_mutex_);
+        std::cout << "[job " << number << "] " << name << " done in " << seconds << "s" << std::endl;
+        return reply;
+    } catch (const std::exception& e) {
+        ++failed_;
+        {
+            std::lock_guard<std::mutex> lock(print_mutex_);
+            std::cerr << "Error: job " << number << " (" << name << "): " << e.what() << std::endl;
+        }
+        JsonValue reply = errorReply(id, e.what());
+        reply.set("name", JsonValue::makeString(name));
+        return reply;
+    }
+}
+
+std::shared_ptr<const SimulationGrid> SimulationServer::grid(const SimulationConfig& config, bool& cached) {
+    std::lock_guard<std::mutex> lock(grids_mutex_);
+    auto key = std::make_tuple(config.nx, config.ny, config.Lx, config.Ly);
+    auto found = grids_.find(key);
+    cached = found != grids_.end();
+    if (!cached) {
+        found = grids_.emplace(key, makeGrid(config)).first;
+    }
+    return found->second;
+}
+
+void SimulationServer::enter(bool large) {
+    std::unique_lock<std::mutex> lock(gate_mutex_);
+    if (large) {
+        ++large_waiting_;
+        gate_.wait(lock, [this] { return small_running_ == 0 && large_running_ == 0; });
+        --large_waiting_;
+        ++large_running_;
+    } else {
+        // Waiting large jobs go first, so a stream of small ones cannot starve them
+        gate_.wait(lock, [this] { return large_running_ == 0 && large_waiting_ == 0; });
+        ++small_running_;
+    }
+}
+
+void SimulationServer::leave(bool large) {
+    {
+        std::lock_guard<std::mutex> lock(gate_mutex_);
+        --(large ? large_running_ : small_running_);
+    }
+    gate_.notify_all();
+}
+
+JsonValue sendServerRequest(const std::string& socket_path, const JsonValue& request) {
+    int fd = connectTo(socket_path);
+    if (fd < 0) {
+        throw std::runtime_error("Could not connect to " + socket_path + ": " + std::strerror(errno));
+    }
+    if (!sendAll(fd, jsonLine(request))) {
+        ::close(fd);
+        throw std::runtime_error("Could not send the request to " + socket_path);
+    }
+    ::shutdown(fd, SHUT_WR);
+
+    std::string reply;
+    char chunk[4096];
+    while (reply.find('\n') == std::string::npos) {
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Server closed the connection without a reply");
+        }
+        reply.append(chunk, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return parseJson(reply.substr(0, reply.find('\n')));
+}
@@ -0,0 +1,122 @@
+#ifndef SIMULATION_SERVER_H
+#define SIMULATION_SERVER_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <tuple>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+
+#include "WeldingSimulation.h"
+#include "Json.h"
+#include "ThreadPool.h"
+
+struct ServerOptions {
+    std::string socket_path;
+    int workers = 1;                 // Jobs run concurrently
+    long large_cells = 200000;       // Jobs with at least this many cells run alone
+};
+
+// Long-lived simulation process serving jobs over a Unix domain socket.
+//
+// Clients write one JSON request per line and get one JSON reply line per
+// request; replies carry the request's "id" and may arrive out of order.
+// A job is
+//
+//   {"id": 1, "name": "run1", "config": { <config.json sections> },
+//    "options": ["--current", "180", ...]}
+//
+// applied on top of the server's own configuration: "config" first, then
+// "options" (same syntax as the command line and batch files). Results go
+// to <output_dir>/<name> unless the job sets output_dir. The reply holds the
+// statistics and the result files. {"command": "status"} and
+// {"command": "shutdown"} control the server.
+//
+// Jobs run on a shared thread pool. Small jobs run side by side, each with
+// an equal share of the OpenMP threads; a job of at least large_cells cells
+// waits for the running jobs, then runs alone with all threads, and holds
+// back new small jobs until it starts. Grids are built once per geometry
+// and kept for later jobs, and the result cache works as for single runs.
+class SimulationServer {
+public:
+    SimulationServer(const ServerOptions& options, const SimulationConfig& base);
+    ~SimulationServer();
+
+    SimulationServer(const SimulationServer&) = delete;
+    SimulationServer& operator=(const SimulationServer&) = delete;
+
+    // Accept connections until a shutdown request or SIGINT/SIGTERM, then
+    // finish the queued jobs. Throws std::runtime_error if the socket
+    // cannot be bound (e.g. another server is listening on it).
+    void serve();
+
+    // Ask serve() to return (thread-safe)
+    void stop() { stopping_ = true; }
+
+private:
+    struct Connection;
+
+    ServerOptions options_;
+    SimulationConfig base_;
+    int max_threads_;
+    int listen_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::unique_ptr<ThreadPool> pool_;
+    std::mutex print_mutex_;
+
+    // Open client connections, each served by a detached thread
+    std::mutex connections_mutex_;
+    std::condition_variable connections_closed_;
+    int connections_ = 0;
+
+    // Grids by (nx, ny, Lx, Ly)
+    mutable std::mutex grids_mutex_;
+    std::map<std::tuple<int, int, double, double>, std::shared_ptr<const SimulationGrid>> grids_;
+
+    // Output directories of the jobs in runJob(), so two jobs never write
+    // to the same directory
+    std::mutex outputs_mutex_;
+    std::set<std::string> active_outputs_;
+
+    // Admission of concurrent small jobs and exclusive large ones
+    std::mutex gate_mutex_;
+    std::condition_variable gate_;
+    int small_running_ = 0;
+    int large_running_ = 0;
+    int large_waiting_ = 0;
+
+    // Counters for status requests
+    std::atomic<int> next_job_{1};
+    std::atomic<int> queued_{0};
+    std::atomic<int> running_{0};
+    std::atomic<long> completed_{0};
+    std::atomic<long> failed_{0};
+
+    void bindSocket();
+    void handleConnection(std::shared_ptr<Connection> connection);
+    JsonValue statusReply() const;
+
+    // Reserve output_dir for a job (lexically normalised); false if a job
+    // in runJob() already holds it
+    bool claimOutput(const std::string& output_dir);
+    void releaseOutput(const std::string& output_dir);
+
+    // Run one job request; never throws (errors become an "ok": false reply)
+    JsonValue runJob(const JsonValue& request, double queued_seconds);
+
+    std::shared_ptr<const SimulationGrid> grid(const SimulationConfig& config, bool& cached);
+    void enter(bool large);
+    void leave(bool large);
+};
+
+// Client side: send one request line to the server at socket_path and wait
+// for its reply. Throws std::runtime_error if the server cannot be reached
+// or closes the connection first.
+JsonValue sendServerRequest(const std::string& socket_path, const JsonValue& request);
+
+#endif // SIMULATION_SERVER_H
@@ -0,0 +1,341 @@
+#include "Sweep.h"
+#include "BatchRunner.h"
+#include "ConfigLoader.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <random>
+#include <chrono>
+#include <mutex>
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include <omp.h>
+
+namespace {
+
+SweepParameter readParameter(const std::string& name, const JsonValue& v) {
+    SweepParameter p;
+    p.name = name;
+    const std::string where = "parameters." + name;
+
+    if (v.isArray()) {
+        for (size_t k = 0; k < v.array.size(); ++k) {
+            p.values.push_back(requireNumber(v.array[k], where + "[" + std::to_string(k) + "]"));
+        }
+        if (p.values.empty()) {
+            throw std::runtime_error(where + ": no values");
+        }
+        return p;
+    }
+    if (!v.isObject()) {
+        throw std::runtime_error(where + ": expected an object or an array of values");
+    }
+
+    bool has_min = false, has_max = false;
+    for (const auto& member : v.object) {
+        const std::string key = where + "." + member.first;
+        if (member.first == "min") {
+            p.min = requireNumber(member.second, key);
+            has_min = true;
+        } else if (member.first == "max") {
+            p.max = requireNumber(member.second, key);
+            has_max = true;
+        } else if (member.first == "levels") {
+            double levels = requireNumber(member.second, key);
+            if (levels < 1 || levels != static_cast<int>(levels)) {
+                throw std::runtime_error(key + ": expected a positive integer");
+            }
+            p.levels = static_cast<int>(levels);
+        } else if (member.first == "values") {
+            p = readParameter(name, member.second);
+            return p;
+        } else {
+            throw std::runtime_error("unknown key '" + key + "'");
+        }
+    }
+    if (!has_min || !has_max) {
+        throw std::runtime_error(where + ": min and max are required");
+    }
+    return p;
+}
+
+// Uniform double in [0, 1) from the top 53 bits (portable across libraries)
+double unitDouble(std::mt19937_64& rng) {
+    return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+} // namespace
+
+SweepDesign readSweepFile(const std::string& filename, const SimulationConfig& base) {
+    JsonValue root = readJsonFile(filename);
+    SweepDesign design;
+    design.base = base;
+
+    try {
+        if (!root.isObject()) {
+            throw std::runtime_error("sweep file must be a JSON object");
+        }
+
+        for (const auto& member : root.object) {
+            const std::string& key = member.first;
+            const JsonValue& v = member.second;
+            if (key == "design") {
+                if (v.isString() && v.string == "grid") {
+                    design.type = SweepDesign::Type::Grid;
+                } else if (v.isString() && v.string == "lhs") {
+                    design.type = SweepDesign::Type::LatinHypercube;
+                } else {
+                    throw std::runtime_error("design: use \"grid\" or \"lhs\"");
+                }
+            } else if (key == "samples") {
+                design.samples = static_cast<int>(requireNumber(v, key));
+            } else if (key == "seed") {
+                design.seed = static_cast<std::uint64_t>(requireNumber(v, key));
+            } else if (key == "write_results") {
+                if (!v.isBool()) {
+                    throw std::runtime_error("write_results: expected true or false");
+                }
+                design.write_results = v.boolean;
+            } else if (key == "config") {
+                applyConfigJson(v, design.base);
+            } else if (key == "parameters") {
+                if (!v.isObject()) {
+                    throw std::runtime_error("parameters: expected an object");
+                }
+                for (const auto& param : v.object) {
+                    design.parameters.push_back(readParameter(param.first, param.second));
+                }
+            } else {
+                throw std::runtime_error("unknown key '" + key + "'");
+            }
+        }
+
+        if (design.parameters.empty()) {
+            throw std::runtime_error("no parameters to sweep");
+        }
+
+        for (const auto& p : design.parameters) {
+            validateParameterName(design.base, p.name);  // Rejects unknown names early
+
+            if (design.type == SweepDesign::Type::Grid && p.values.empty() && p.levels == 0) {
+                throw std::runtime_error("parameters." + p.name + ": grid designs need levels or values");
+            }
+            if (design.type == SweepDesign::Type::LatinHypercube && !p.values.empty()) {
+                throw std::runtime_error("parameters." + p.name + ": lhs designs need min and max");
+            }
+        }
+        if (design.type == SweepDesign::Type::LatinHypercube && design.samples < 1) {
+            throw std::runtime_error("lhs designs need samples >= 1");
+        }
+    } catch (const std::exception& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+
+    return design;
+}
+
+std::vector<std::vector<double>> sweepPoints(const SweepDesign& design) {
+    const size_t n_params = design.parameters.size();
+    std::vector<std::vector<double>> points;
+
+    if (design.type == SweepDesign::Type::Grid) {
+        // Levels per parameter, then the full factorial (last parameter fastest)
+        std::vector<std::vector<double>> levels;
+        for (const auto& p : design.parameters) {
+            std::vector<double> l = p.values;
+            if (l.empty()) {
+                for (int k = 0; k < p.levels; ++k) {
+                    l.push_back(p.levels == 1 ? p.min : p.min + (p.max - p.min) * k / (p.levels - 1));
+                }
+            }
+            levels.push_back(l);
+        }
+
+        std::vector<size_t> index(n_params, 0);
+        while (true) {
+            std::vector<double> point(n_params);
+            for (size_t k = 0; k < n_params; ++k) {
+                point[k] = levels[k][index[k]];
+            }
+            points.push_back(point);
+
+            size_t k = n_params;
+            while (k > 0 && ++index[k - 1] == levels[k - 1].size()) {
+                index[k - 1] = 0;
+                --k;
+            }
+            if (k == 0) {
+                break;
+            }
+        }
+        return points;
+    }
+
+    // Latin hypercube: a random permutation of the strata per parameter and
+    // a uniform offset inside each stratum
+    const int n = design.samples;
+    std::mt19937_64 rng(design.seed);
+    points.assign(n, std::vector<double>(n_params));
+
+    for (size_t k = 0; k < n_params; ++k) {
+        std::vector<int> strata(n);
+        for (int s = 0; s < n; ++s) {
+            strata[s] = s;
+        }
+        for (int s = n - 1; s > 0; --s) {
+            std::swap(strata[s], strata[rng() % (s + 1)]);
+        }
+
+        const SweepParameter& p = design.parameters[k];
+        for (int s = 0; s < n; ++s) {
+            double u = (strata[s] + unitDouble(rng)) / n;
+            points[s][k] = p.min + (p.max - p.min) * u;
+        }
+    }
+    return points;
+}
+
+std::vector<SweepResult> runSweep(const SweepDesign& design, int jobs,
+                                  const SweepObserver& observer) {
+    const std::vector<std::vector<double>> points = sweepPoints(design);
+    const int n = static_cast<int>(points.size());
+    jobs = std::max(1, std::min(jobs, n));
+    const int threads_per_job = std::max(1, omp_get_max_threads() / jobs);
+
+    // Per-run configurations; only final-state outputs are needed
+    std::vector<SimulationConfig> configs(n, design.base);
+    for (int r = 0; r < n; ++r) {
+        SimulationConfig& c = configs[r];
+        for (size_t k = 0; k < design.parameters.size(); ++k) {
+            setConfigValue(c, design.parameters[k].name, points[r][k]);
+        }
+        c.save_video_frames = false;
+        c.snapshot_time = -1.0;
+        c.history_chunk_rows = 0;
+        c.checkpoint_interval = 0;
+        c.restart_file.clear();
+
+        std::ostringstream dir;
+        dir << design.base.output_dir << "/run_" << std::setw(4) << std::setfill('0') << r + 1;
+        c.output_dir = dir.str();
+    }
+
+    // Build each distinct grid once
+    std::map<std::tuple<int, int, double, double>, std::shared_ptr<const SimulationGrid>> grids;
+    for (const auto& c : configs) {
+        auto key = std::make_tuple(c.nx, c.ny, c.Lx, c.Ly);
+        if (grids.find(key) == grids.end()) {
+            grids[key] = makeGrid(c);
+        }
+    }
+
+    std::cout << "Sweep: " << n << " runs of " << design.parameters.size() << " parameters, "
+              << jobs << " at a time, " << threads_per_job << " OpenMP threads each" << std::endl;
+
+    std::vector<SweepResult> results(n);
+    std::mutex print_mutex;
+    int finished = 0;
+
+    ThreadPool pool(jobs);
+    for (int r = 0; r < n; ++r) {
+        pool.submit([&, r]() {
+            omp_set_num_threads(threads_per_job);
+
+            const SimulationConfig& c = configs[r];
+            SweepResult& result = results[r];
+            result.values = points[r];
+
+            auto start = std::chrono::steady_clock::now();
+            try {
+                auto grid = grids.at(std::make_tuple(c.nx, c.ny, c.Lx, c.Ly));
+                WeldingSimulation sim(c, grid, nullptr);
+                sim.run();
+                if (design.write_results) {
+                    prepareOutputDirectories(c);
+                    sim.exportResults();
+                }
+                if (observer) {
+                    observer(r, sim);
+                }
+
+                result.stats = sim.statistics();
+                const ThermalHistory& history = sim.history();
+                for (int k = 0; k < history.seriesCount(); ++k) {
+                    result.probe_names.push_back(history.name(k));
+                    result.probe_t85.push_back(history.coolingTime(k, c.T_t85_high, c.T_t85_low));
+                }
+                result.ok = true;
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            result.seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(print_mutex);
+            ++finished;
+            if (result.ok) {
+                std::cout << "[" << finished << "/" << n << "] run " << r + 1
+                          << " done in " << result.seconds << "s" << std::endl;
+            } else {
+                std::cerr << "Error: sweep run " << r + 1 << ": " << result.error << std::endl;
+            }
+        });
+    }
+    pool.wait();
+
+    return results;
+}
+
+void writeSweepSummary(std::ostream& out, const SweepDesign& design,
+                       const std::vector<SweepResult>& results) {
+    // Probe columns come from the first successful run
+    std::vector<std::string> probe_names;
+    for (const auto& r : results) {
+        if (r.ok) {
+            probe_names = r.probe_names;
+            break;
+        }
+    }
+
+    out << "run";
+    for (const auto& p : design.parameters) {
+        out << "," << p.name;
+    }
+    out << ",T_peak,fusion_area_mm2,HAZ_area_mm2,peak_cooling_rate,t85_min,t85_max";
+    for (const auto& name : probe_names) {
+        out << ",t85_" << name;
+    }
+    out << ",seconds,status" << std::endl;
+
+    out << std::setprecision(10);
+    for (size_t r = 0; r < results.size(); ++r) {
+        const SweepResult& res = results[r];
+        out << r + 1;
+        for (double v : res.values) {
+            out << "," << v;
+        }
+
+        if (res.ok) {
+            out << "," << res.stats.T_peak
+                << "," << res.stats.fusion_area * 1e6
+                << "," << res.stats.HAZ_area * 1e6
+                << "," << res.stats.peak_cooling_rate
+                << "," << res.stats.t85_min
+                << "," << res.stats.t85_max;
+            for (size_t k = 0; k < probe_names.size(); ++k) {
+                out << "," << (k < res.probe_t85.size() ? res.probe_t85[k] : -1.0);
+            }
+            out << "," << res.seconds << ",ok" << std::endl;
+        } else {
+            for (size_t k = 0; k < 6 + probe_names.size(); ++k) {
+                out << ",";
+            }
+            std::string error = res.error;
+            std::replace(error.begin(), error.end(), ',', ';');
+            out << "," << res.seconds << ",error: " << error << std::endl;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <ostream>
+#include <functional>
+
+#include "WeldingSimulation.h"
+
+// One swept parameter
+struct SweepParameter {
+    std::string name;            // setConfigValue() name: "I", "v_weld", "material_2.k", ...
+    double min = 0.0;
+    double max = 0.0;
+    int levels = 0;              // Grid: evenly spaced levels from min to max
+    std::vector<double> values;  // Grid: explicit levels (instead of min/max/levels)
+};
+
+// Parameter study description, read from a JSON file:
+//
+//   {
+//     "design": "grid" | "lhs",
+//     "samples": 32,                  (lhs: number of runs)
+//     "seed": 1,                      (lhs)
+//     "write_results": false,         (also write each run's result files)
+//     "config": { ... },              (config.json document for the base case)
+//     "parameters": {
+//       "I":            { "min": 120, "max": 200, "levels": 5 },
+//       "v_weld":       [ 0.004, 0.006, 0.008 ],
+//       "material_2.k": { "min": 14.0, "max": 20.0 }
+//     }
+//   }
+//
+// A grid design runs the full factorial of all levels; a Latin hypercube
+// draws `samples` points with exactly one point in each of `samples`
+// equal-width strata of every parameter.
+struct SweepDesign {
+    enum class Type { Grid, LatinHypercube };
+
+    Type type = Type::Grid;
+    int samples = 0;
+    std::uint64_t seed = 1;
+    bool write_results = false;
+    SimulationConfig base;
+    std::vector<SweepParameter> parameters;
+};
+
+// Outcome of one sweep run
+struct SweepResult {
+    std::vector<double> values;                 // Parameter values, in design order
+    SimulationStatistics stats;
+    std::vector<std::string> probe_names;
+    std::vector<double> probe_t85;              // t8/5 at each probe (s, -1 = not reached)
+    double seconds = 0.0;
+    bool ok = false;
+    std::string error;
+};
+
+// Read a sweep file; `base` supplies defaults under its "config" section.
+// Throws std::runtime_error on unreadable files or invalid designs.
+SweepDesign readSweepFile(const std::string& filename, const SimulationConfig& base);
+
+// Parameter values of every run (one row per run, one column per parameter).
+// Deterministic for a given design and seed.
+std::vector<std::vector<double>> sweepPoints(const SweepDesign& design);
+
+// Called on the worker thread after run `run` (0-based) finishes, while the
+// simulation is still alive; an exception marks the run as failed
+using SweepObserver = std::function<void(int run, const WeldingSimulation& sim)>;
+
+// Run every point on a work-stealing pool of `jobs` threads, each with an
+// equal share of the OpenMP threads. Runs are silent and use the result cache.
+std::vector<SweepResult> runSweep(const SweepDesign& design, int jobs,
+                                  const SweepObserver& observer = nullptr);
+
+// Tidy summary: one row per run with its parameters, peak temperature, zone
+// areas, cooling metrics and t8/5 at every probe
+void writeSweepSummary(std::ostream& out, const SweepDesign& design,
+                       const std::vector<SweepResult>& results);
+
+#endif // SWEEP_H
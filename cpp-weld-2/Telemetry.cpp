@@ -0,0 +1,211 @@
+#include "Telemetry.h"
+#include "Json.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+TelemetryPublisher::TelemetryPublisher(const std::string& path, double rate_hz)
+    : path_(path), period_(rate_hz > 0.0 ? 1.0 / rate_hz : 0.0) {
+    if (rate_hz <= 0.0) {
+        throw std::invalid_argument("telemetry rate must be positive");
+    }
+    sockaddr_un address;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Invalid telemetry path '" + path + "'");
+    }
+    last_wall_ = std::chrono::steady_clock::now();
+    thread_ = std::thread(&TelemetryPublisher::loop, this);
+}
+
+TelemetryPublisher::~TelemetryPublisher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    disconnect();
+}
+
+bool TelemetryPublisher::post(const TelemetryRecord& record) {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
+    }
+    slot_ = record;
+    slot_full_ = true;
+    due_.store(false, std::memory_order_relaxed);
+    lock.unlock();
+    wake_.notify_all();
+    return true;
+}
+
+void TelemetryPublisher::finish(const TelemetryRecord& record) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slot_ = record;
+        slot_full_ = true;
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void TelemetryPublisher::loop() {
+    // A reader that goes away must not kill the process: EPIPE instead of SIGPIPE
+    sigset_t block;
+    sigemptyset(&block);
+    sigaddset(&block, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &block, nullptr);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return slot_full_ || stopping_; });
+        if (slot_full_) {
+            TelemetryRecord record = std::move(slot_);
+            slot_full_ = false;
+            lock.unlock();
+            send(format(record, std::chrono::steady_clock::now()));
+            lock.lock();
+        }
+        if (stopping_ && !slot_full_) {
+            break;
+        }
+
+        // Next tick
+        wake_.wait_for(lock, period_, [this] { return stopping_; });
+        due_.store(true, std::memory_order_relaxed);
+    }
+}
+
+std::string TelemetryPublisher::format(const TelemetryRecord& r, std::chrono::steady_clock::time_point now) {
+    // Step rate over the interval since the previous record
+    const double interval = std::chrono::duration<double>(now - last_wall_).count();
+    if (interval > 0.0 && r.step > last_step_) {
+        step_rate_ = (r.step - last_step_) / interval;
+    }
+    last_step_ = r.step;
+    last_wall_ = now;
+
+    JsonValue pool = JsonValue::makeObject();
+    pool.set("length_mm", JsonValue::makeNumber(r.pool_length * 1e3));
+    pool.set("width_mm", JsonValue::makeNumber(r.pool_width * 1e3));
+    pool.set("area_mm2", JsonValue::makeNumber(r.pool_area * 1e6));
+
+    JsonValue line = JsonValue::makeObject();
+    line.set("run", JsonValue::makeString(r.run));
+    line.set("step", JsonValue::makeNumber(r.step));
+    line.set("steps", JsonValue::makeNumber(r.steps));
+    line.set("time", JsonValue::makeNumber(r.time));
+    line.set("progress", JsonValue::makeNumber(r.steps > 0 ? static_cast<double>(r.step) / r.steps : 1.0));
+    line.set("step_rate", JsonValue::makeNumber(step_rate_));
+    line.set("eta_s", step_rate_ > 0.0 ? JsonValue::makeNumber((r.steps - r.step) / step_rate_) : JsonValue());
+    line.set("T_peak", JsonValue::makeNumber(r.T_peak));
+    line.set("melt_pool", pool);
+    if (!r.phases.empty()) {
+        JsonValue phases = JsonValue::makeObject();
+        for (const auto& p : r.phases) {
+            phases.set(p.first, JsonValue::makeNumber(p.second));
+        }
+        line.set("phase_seconds", phases);
+    }
+    line.set("done", JsonValue::makeBool(r.done));
+
+    std::ostringstream out;
+    writeJson(out, line, JSON_COMPACT);
+    out << '\n';
+    return out.str();
+}
+
+bool TelemetryPublisher::connect() {
+    struct stat info;
+    if (::stat(path_.c_str(), &info) != 0) {
+        if (!warned_) {
+            std::cerr << "Warning: telemetry path " << path_ << " does not exist yet" << std::endl;
+            warned_ = true;
+        }
+        return false;
+    }
+
+    if (S_ISFIFO(info.st_mode)) {
+        // ENXIO until a reader has the FIFO open
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        return fd_ >= 0;
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        if (!warned_) {
+            std::cerr << "Warning: telemetry path " << path_ << " is neither a socket nor a FIFO" << std::endl;
+            warned_ = true;
+        }
+        return false;
+    }
+
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        return false;
+    }
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path_.c_str(), sizeof(address.sun_path) - 1);
+    if (::connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+void TelemetryPublisher::send(const std::string& line) {
+    if (fd_ < 0 && !connect()) {
+        dropped_.fetch_add(1);
+        return;
+    }
+
+    // Finish a partially written line first; lines are never interleaved
+    if (!pending_.empty() && (writePending() < 0 || !pending_.empty())) {
+        dropped_.fetch_add(1);
+        return;
+    }
+
+    pending_ = line;
+    if (writePending() <= 0) {
+        pending_.clear();
+        dropped_.fetch_add(1);
+        return;
+    }
+    written_.fetch_add(1);
+}
+
+long TelemetryPublisher::writePending() {
+    ssize_t n = ::write(fd_, pending_.data(), pending_.size());
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        disconnect();    // Reader gone: reconnect on a later tick
+        return -1;
+    }
+    pending_.erase(0, static_cast<size_t>(n));
+    return static_cast<long>(n);
+}
+
+void TelemetryPublisher::disconnect() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    pending_.clear();
+}
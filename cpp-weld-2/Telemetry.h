@@ -0,0 +1,91 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+// State of a running simulation at one time step
+struct TelemetryRecord {
+    std::string run;                // Output directory of the run
+    int step = 0;
+    int steps = 0;                  // Total steps of the run
+    double time = 0.0;              // Simulation time (s)
+    double T_peak = 0.0;            // Hottest cell of the plate (K)
+    double pool_length = 0.0;       // Melt pool extent in x (m)
+    double pool_width = 0.0;        // Melt pool extent in y (m)
+    double pool_area = 0.0;         // m²
+    std::vector<std::pair<std::string, double>> phases;  // Cumulative phase time (s), profiled builds
+    bool done = false;
+};
+
+// Publishes newline-delimited JSON telemetry to a Unix domain socket or a
+// FIFO at a fixed rate, from its own thread.
+//
+// The solver calls due() every step (one relaxed atomic load) and, when it
+// is set, post() with a fresh record. post() only try-locks the hand-off
+// slot, and the thread writes with non-blocking I/O: a missing, slow or
+// disconnected reader costs dropped lines, never solver time. The thread
+// adds wall-clock step rate and ETA, and reconnects on every tick while no
+// reader is attached. A socket must already be listening (SOCK_STREAM); a
+// FIFO needs a reader to open it.
+class TelemetryPublisher {
+public:
+    TelemetryPublisher(const std::string& path, double rate_hz);
+
+    // Sends the last posted record if it is still pending, then joins
+    ~TelemetryPublisher();
+
+    TelemetryPublisher(const TelemetryPublisher&) = delete;
+    TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+    // True when the publisher wants a new record
+    bool due() const { return due_.load(std::memory_order_relaxed); }
+
+    // Hand over a record; returns false (record dropped) if the thread is busy
+    bool post(const TelemetryRecord& record);
+
+    // Post the final record and wait until it has been written or dropped
+    void finish(const TelemetryRecord& record);
+
+    // Lines written and dropped so far
+    long linesWritten() const { return written_.load(); }
+    long linesDropped() const { return dropped_.load(); }
+
+private:
+    std::string path_;
+    std::chrono::duration<double> period_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    TelemetryRecord slot_;           // Guarded by mutex_
+    bool slot_full_ = false;
+    bool stopping_ = false;
+
+    std::atomic<bool> due_{true};
+    std::atomic<long> written_{0};
+    std::atomic<long> dropped_{0};
+
+    // Publisher-thread state
+    int fd_ = -1;
+    std::string pending_;            // Unsent tail of a partially written line
+    bool warned_ = false;
+    int last_step_ = 0;
+    std::chrono::steady_clock::time_point last_wall_;
+    double step_rate_ = 0.0;         // Steps per wall-clock second
+
+    void loop();
+    std::string format(const TelemetryRecord& record, std::chrono::steady_clock::time_point now);
+    bool connect();
+    void send(const std::string& line);
+    long writePending();   // Bytes of pending_ written, 0 if the reader is full, -1 on error
+    void disconnect();
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,156 @@
+#include "ThermalHistory.h"
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <filesystem>
+
+void ThermalHistory::reset(const std::vector<std::string>& names, int capacity) {
+    names_ = names;
+    capacity_ = std::max(1, capacity);
+    size_ = 0;
+    time_.assign(capacity_, 0.0);
+    values_.assign(names_.size() * static_cast<size_t>(capacity_), 0.0);
+    rows_streamed_ = 0;
+    stream_bytes_ = 0;
+}
+
+void ThermalHistory::record(double t, const double* values) {
+    if (size_ == capacity_) {
+        if (!streaming()) {
+            throw std::runtime_error("Thermal history capacity exceeded");
+        }
+        flush();
+    }
+
+    time_[size_] = t;
+    for (size_t k = 0; k < names_.size(); ++k) {
+        values_[k * capacity_ + size_] = values[k];
+    }
+    ++size_;
+}
+
+void ThermalHistory::openStream(const std::string& filename) {
+    stream_.close();
+    stream_.clear();
+    stream_.open(filename, std::ios::trunc);
+    if (!stream_.is_open()) {
+        throw std::runtime_error("Could not open history stream " + filename);
+    }
+    stream_file_ = filename;
+    writeHeader(stream_);
+    stream_.flush();
+    stream_bytes_ = static_cast<std::uint64_t>(stream_.tellp());
+    rows_streamed_ = 0;
+}
+
+void ThermalHistory::resumeStream(const std::string& filename, std::uint64_t bytes,
+                                  std::uint64_t rows) {
+    stream_.close();
+    stream_.clear();
+
+    std::error_code ec;
+    std::filesystem::resize_file(filename, bytes, ec);
+    if (ec) {
+        throw std::runtime_error("Could not resume history stream " + filename + ": " + ec.message());
+    }
+
+    stream_.open(filename, std::ios::app);
+    if (!stream_.is_open()) {
+        throw std::runtime_error("Could not open history stream " + filename);
+    }
+    stream_file_ = filename;
+    stream_bytes_ = bytes;
+    rows_streamed_ = rows;
+}
+
+void ThermalHistory::flush() {
+    if (!streaming()) {
+        return;
+    }
+    writeRows(stream_);
+    stream_.flush();
+    stream_bytes_ = static_cast<std::uint64_t>(stream_.tellp());
+    rows_streamed_ += size_;
+    size_ = 0;
+}
+
+double ThermalHistory::coolingTime(int k, double T_high, double T_low) const {
+    const double* T = series(k);
+    double t_high = -1.0;
+    int prev = -1;  // Last row with a sample for this series
+
+    for (int row = 0; row < size_; ++row) {
+        if (std::isnan(T[row])) {
+            continue;
+        }
+        if (prev >= 0) {
+            const double T_prev = T[prev];
+            const double T_now = T[row];
+            const double t0 = time_[prev];
+            const double t1 = time_[row];
+
+            if (t_high < 0.0 && T_prev >= T_high && T_now < T_high) {
+                t_high = t1 - (t1 - t0) * (T_high - T_now) / (T_prev - T_now);
+            }
+            if (t_high >= 0.0 && T_prev >= T_low && T_now < T_low) {
+                double t_low = t1 - (t1 - t0) * (T_low - T_now) / (T_prev - T_now);
+                return t_low - t_high;
+            }
+        }
+        prev = row;
+    }
+    return -1.0;
+}
+
+void ThermalHistory::copyRows(std::vector<double>& time, std::vector<double>& values) const {
+    time.assign(time_.begin(), time_.begin() + size_);
+    values.resize(names_.size() * static_cast<size_t>(size_));
+    for (size_t k = 0; k < names_.size(); ++k) {
+        std::copy(values_.begin() + k * capacity_, values_.begin() + k * capacity_ + size_,
+                  values.begin() + k * size_);
+    }
+}
+
+void ThermalHistory::restoreRows(const std::vector<double>& time, const std::vector<double>& values) {
+    const int rows = static_cast<int>(time.size());
+    if (rows > capacity_ || values.size() != names_.size() * time.size()) {
+        throw std::runtime_error("Thermal history does not fit the restored rows");
+    }
+
+    std::copy(time.begin(), time.end(), time_.begin());
+    for (size_t k = 0; k < names_.size(); ++k) {
+        std::copy(values.begin() + k * rows, values.begin() + (k + 1) * rows,
+                  values_.begin() + k * capacity_);
+    }
+    size_ = rows;
+}
+
+void ThermalHistory::writeCsv(std::ostream& out) const {
+    writeHeader(out);
+    writeRows(out);
+}
+
+void ThermalHistory::writeHeader(std::ostream& out) const {
+    out << "time";
+    for (const auto& name : names_) {
+        out << ",T_" << name;
+    }
+    out << "\n";
+}
+
+void ThermalHistory::writeRows(std::ostream& out) const {
+    out << std::setprecision(6) << std::fixed;
+    for (int row = 0; row < size_; ++row) {
+        out << time_[row];
+        for (size_t k = 0; k < names_.size(); ++k) {
+            // Rows where a probe was not sampled are left empty
+            double value = values_[k * capacity_ + row];
+            out << ",";
+            if (!std::isnan(value)) {
+                out << value;
+            }
+        }
+        out << "\n";
+    }
+}
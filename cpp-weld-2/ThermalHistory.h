@@ -0,0 +1,79 @@
+#ifndef THERMAL_HISTORY_H
+#define THERMAL_HISTORY_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <ostream>
+
+// Time series of the monitoring point temperatures.
+//
+// Storage is struct-of-arrays: one time column plus one contiguous column per
+// series, all allocated once by reset(). In memory mode the capacity is the
+// full number of steps, so record() never reallocates. In streaming mode the
+// capacity is a fixed chunk; when the chunk is full it is appended to a CSV
+// file and reused, so memory stays bounded for arbitrarily long runs.
+class ThermalHistory {
+public:
+    // Allocate `capacity` rows for the named series and drop all data
+    void reset(const std::vector<std::string>& names, int capacity);
+
+    // Append one row; `values` holds one entry per series
+    void record(double t, const double* values);
+
+    // Stream full chunks to `filename` (truncated and given a CSV header)
+    void openStream(const std::string& filename);
+
+    // Reopen a stream after a restart: the file is cut back to `bytes`,
+    // which held `rows` rows when the checkpoint was taken
+    void resumeStream(const std::string& filename, std::uint64_t bytes, std::uint64_t rows);
+
+    // Append the rows held in memory to the stream and clear them
+    void flush();
+
+    bool streaming() const { return stream_.is_open(); }
+    const std::string& streamFile() const { return stream_file_; }
+    std::uint64_t rowsStreamed() const { return rows_streamed_; }
+    std::uint64_t streamBytes() const { return stream_bytes_; }
+
+    int seriesCount() const { return static_cast<int>(names_.size()); }
+    const std::string& name(int k) const { return names_[k]; }
+
+    // Rows currently held in memory
+    int size() const { return size_; }
+    double time(int row) const { return time_[row]; }
+    const double* times() const { return time_.data(); }
+    double value(int k, int row) const { return values_[static_cast<size_t>(k) * capacity_ + row]; }
+    const double* series(int k) const { return values_.data() + static_cast<size_t>(k) * capacity_; }
+
+    // Cooling time of series k between the first downward crossing of T_high
+    // and the next downward crossing of T_low (t8/5 for the default
+    // thresholds), interpolated between samples. -1 if either is not reached
+    // in the rows held in memory.
+    double coolingTime(int k, double T_high, double T_low) const;
+
+    // Copy the in-memory rows out as compact series-major arrays, and back
+    void copyRows(std::vector<double>& time, std::vector<double>& values) const;
+    void restoreRows(const std::vector<double>& time, const std::vector<double>& values);
+
+    // Write the in-memory rows as CSV ("time,T_<name>,...")
+    void writeCsv(std::ostream& out) const;
+
+private:
+    std::vector<std::string> names_;
+    std::vector<double> time_;
+    std::vector<double> values_;  // Series-major: values_[k * capacity_ + row]
+    int capacity_ = 0;
+    int size_ = 0;
+
+    std::ofstream stream_;
+    std::string stream_file_;
+    std::uint64_t rows_streamed_ = 0;
+    std::uint64_t stream_bytes_ = 0;
+
+    void writeHeader(std::ostream& out) const;
+    void writeRows(std::ostream& out) const;
+};
+
+#endif // THERMAL_HISTORY_H
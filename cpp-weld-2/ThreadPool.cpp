@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads, bool fifo) : fifo_(fifo) {
+    threads = std::max(1, threads);
+    for (int w = 0; w < threads; ++w) {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
+    for (int w = 0; w < threads; ++w) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, w);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        all_done_.wait(lock, [this] { return unfinished_ == 0; });
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        // Queued and counted under the state lock, so a worker can never
+        // take a task before it is counted or sleep while one is waiting
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        TaskQueue& q = *queues_[next_queue_++ % queues_.size()];
+        {
+            std::lock_guard<std::mutex> queue_lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        ++queued_;
+        ++unfinished_;
+    }
+    work_available_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    all_done_.wait(lock, [this] { return unfinished_ == 0; });
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool ThreadPool::tryTake(int self, std::function<void()>& task) {
+    const int n = static_cast<int>(queues_.size());
+    for (int k = 0; k < n; ++k) {
+        TaskQueue& q = *queues_[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) {
+            continue;
+        }
+        // Own queue: newest first (unless fifo_); victims: oldest first
+        if (k == 0 && !fifo_) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+        } else {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(int self) {
+    while (true) {
+        std::function<void()> task;
+        if (tryTake(self, task)) {
+            {
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                --queued_;
+            }
+
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (--unfinished_ == 0) {
+                all_done_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        work_available_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+// Fixed-size work-stealing thread pool.
+//
+// Each worker owns a task deque. Submitted tasks are dealt round-robin;
+// a worker takes from the back of its own deque and, when that is empty,
+// steals from the front of the others, so a worker that drew short runs
+// keeps helping until every queue is drained. With `fifo`, workers take
+// their own tasks oldest first too, so tasks start in submission order.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads, bool fifo = false);
+
+    // Waits for all submitted tasks, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()); }
+
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished. Rethrows the first
+    // exception a task let escape (later ones are dropped).
+    void wait();
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex state_mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+    size_t queued_ = 0;       // Tasks waiting in some queue
+    size_t unfinished_ = 0;   // Queued or running
+    size_t next_queue_ = 0;   // Round-robin submit target
+    bool fifo_ = false;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+
+    bool tryTake(int self, std::function<void()>& task);
+    void workerLoop(int self);
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,175 @@
+#include "TorchPath.h"
+#include "WeldingSimulation.h"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+TorchPath::TorchPath(const SimulationConfig& config)
+    : weave_amplitude_(config.path.weave_amplitude),
+      weave_omega_(2.0 * M_PI * config.path.weave_frequency),
+      along_y_(config.weld_direction == "y"),
+      x_start_(config.x_start), y_arc_(config.y_arc), v_weld_(config.v_weld),
+      Lx_(config.Lx), Ly_(config.Ly) {
+
+    const TorchPathSpec& spec = config.path;
+    if (spec.weave_amplitude < 0.0 || spec.weave_frequency < 0.0) {
+        throw std::invalid_argument("path.weave: amplitude and frequency must not be negative");
+    }
+
+    if (spec.segments.empty()) {
+        // Until the arc leaves the plate at its far edge
+        length_ = along_y_ ? Ly_ : Lx_ - x_start_;
+        duration_ = length_ / v_weld_;
+        return;
+    }
+
+    double x, y;
+    if (std::isnan(spec.x0) || std::isnan(spec.y0)) {
+        arcPosition(config, 0.0, x, y);
+    } else {
+        x = spec.x0;
+        y = spec.y0;
+    }
+
+    double t = 0.0;
+    double s = 0.0;
+    for (size_t k = 0; k < spec.segments.size(); ++k) {
+        const PathSegment& p = spec.segments[k];
+        const std::string where = "path.segments[" + std::to_string(k) + "]";
+
+        const double v0 = (p.speed_start < 0.0) ? config.v_weld : p.speed_start;
+        const double v1 = (p.speed_end < 0.0) ? v0 : p.speed_end;
+        if (!(v0 > 0.0 && v1 > 0.0)) {
+            throw std::invalid_argument(where + ".speed: must be positive");
+        }
+        if (p.power_start < 0.0 || p.power_end < 0.0) {
+            throw std::invalid_argument(where + ".power: must not be negative");
+        }
+
+        Segment g{};
+        g.kind = p.kind;
+        if (p.kind == PathSegment::Kind::Line) {
+            const double dx = p.x - x;
+            const double dy = p.y - y;
+            g.L = std::hypot(dx, dy);
+            if (!(g.L > 0.0)) {
+                throw std::invalid_argument(where + ": line of zero length");
+            }
+            g.x0 = x;
+            g.y0 = y;
+            g.ux = dx / g.L;
+            g.uy = dy / g.L;
+            x = p.x;
+            y = p.y;
+        } else {
+            const double sweep = p.sweep * M_PI / 180.0;
+            g.x0 = p.x;
+            g.y0 = p.y;
+            g.r = std::hypot(x - p.x, y - p.y);
+            if (!(g.r > 0.0) || sweep == 0.0) {
+                throw std::invalid_argument(where + ": arc needs a centre off the start point and a non-zero sweep");
+            }
+            g.a0 = std::atan2(y - p.y, x - p.x);
+            g.turn = (sweep > 0.0) ? 1.0 : -1.0;
+            g.L = g.r * std::fabs(sweep);
+            x = p.x + g.r * std::cos(g.a0 + sweep);
+            y = p.y + g.r * std::sin(g.a0 + sweep);
+        }
+
+        // Linear speed ramp: mean speed (v0 + v1) / 2 over the segment
+        g.T = 2.0 * g.L / (v0 + v1);
+        g.t0 = t;
+        g.s0 = s;
+        g.v0 = v0;
+        g.dv = v1 - v0;
+        g.p0 = p.power_start;
+        g.dp = p.power_end - p.power_start;
+        segments_.push_back(g);
+
+        t += g.T;
+        s += g.L;
+    }
+    duration_ = t;
+    length_ = s;
+
+    // Buckets no wider than the shortest segment, so a bucket overlaps at
+    // most two segments and at(t) steps forward at most once; at least four
+    // per segment on average. The count is capped (MAX_BUCKETS) for paths
+    // with a few very short segments, where a lookup may step more.
+    double T_min = duration_;
+    for (const auto& g : segments_) {
+        T_min = std::min(T_min, g.T);
+    }
+    const double wanted = std::max(4.0 * segments_.size(), std::ceil(duration_ / T_min));
+    const int buckets = static_cast<int>(std::min(wanted, static_cast<double>(MAX_BUCKETS)));
+    bucket_width_ = duration_ / buckets;
+    bucket_.resize(buckets);
+    int k = 0;
+    for (int b = 0; b < buckets; ++b) {
+        while (k + 1 < segmentCount() && segments_[k + 1].t0 <= b * bucket_width_) {
+            ++k;
+        }
+        bucket_[b] = k;
+    }
+}
+
+TorchState TorchPath::at(double t) const {
+    TorchState state;
+    double tx, ty;   // Unit tangent
+
+    if (segments_.empty()) {
+        // Same arithmetic as arcPosition() and arcOnPlate()
+        if (along_y_) {
+            state.x = Lx_ / 2.0;
+            state.y = -Ly_ / 2.0 + v_weld_ * t;
+            state.on = state.y >= -Ly_ / 2.0 && state.y <= Ly_ / 2.0;
+            tx = 0.0;
+            ty = 1.0;
+        } else {
+            state.x = x_start_ + v_weld_ * t;
+            state.y = y_arc_;
+            state.on = state.x <= Lx_;
+            tx = 1.0;
+            ty = 0.0;
+        }
+        state.distance = std::min(v_weld_ * t, length_);
+    } else {
+        const int b = std::min(static_cast<int>(bucket_.size()) - 1,
+                               std::max(0, static_cast<int>(t / bucket_width_)));
+        int k = bucket_[b];
+        while (k + 1 < segmentCount() && t >= segments_[k + 1].t0) {
+            ++k;
+        }
+
+        const Segment& g = segments_[k];
+        const double tau = std::min(std::max(t - g.t0, 0.0), g.T);
+        const double s = std::min(g.v0 * tau + g.dv * tau * tau / (2.0 * g.T), g.L);
+        place(g, s, state.x, state.y, tx, ty);
+        state.power = g.p0 + g.dp * s / g.L;
+        state.distance = g.s0 + s;
+        state.on = t <= duration_;
+    }
+
+    if (weave_amplitude_ > 0.0) {
+        // Offset along the left normal of the travel direction
+        const double offset = weave_amplitude_ * std::sin(weave_omega_ * t);
+        state.x -= ty * offset;
+        state.y += tx * offset;
+    }
+    return state;
+}
+
+void TorchPath::place(const Segment& g, double s, double& x, double& y, double& tx, double& ty) const {
+    if (g.kind == PathSegment::Kind::Line) {
+        x = g.x0 + g.ux * s;
+        y = g.y0 + g.uy * s;
+        tx = g.ux;
+        ty = g.uy;
+    } else {
+        const double a = g.a0 + g.turn * s / g.r;
+        x = g.x0 + g.r * std::cos(a);
+        y = g.y0 + g.r * std::sin(a);
+        tx = -g.turn * std::sin(a);
+        ty = g.turn * std::cos(a);
+    }
+}
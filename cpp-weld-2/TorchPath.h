@@ -0,0 +1,107 @@
+#ifndef TORCH_PATH_H
+#define TORCH_PATH_H
+
+#include <vector>
+#include <string>
+#include <limits>
+
+struct SimulationConfig;
+
+// One piece of a torch path, starting where the previous piece ends. Speed
+// ramps linearly in time and power linearly in distance along the piece.
+struct PathSegment {
+    enum class Kind { Line, Arc };
+
+    Kind kind = Kind::Line;
+    double x = 0.0;              // Line: end point; arc: centre (m)
+    double y = 0.0;
+    double sweep = 0.0;          // Arc: swept angle (degrees, positive counter-clockwise)
+    double speed_start = -1.0;   // Travel speed (m/s, -1 = v_weld)
+    double speed_end = -1.0;
+    double power_start = 1.0;    // Fraction of the nominal source power
+    double power_end = 1.0;
+};
+
+// Torch path of a run (the "path" section of config.json)
+struct TorchPathSpec {
+    // Start point (m); NaN = the start of the straight path of weld_direction
+    double x0 = std::numeric_limits<double>::quiet_NaN();
+    double y0 = std::numeric_limits<double>::quiet_NaN();
+
+    // Empty = the straight path of weld_direction at v_weld
+    std::vector<PathSegment> segments;
+
+    // Sinusoidal weave across the path: offset = amplitude sin(2 pi f t)
+    double weave_amplitude = 0.0;   // m
+    double weave_frequency = 0.0;   // Hz
+
+    bool empty() const { return segments.empty() && weave_amplitude == 0.0; }
+};
+
+// Torch centre and power at one instant
+struct TorchState {
+    double x = 0.0;
+    double y = 0.0;
+    double power = 1.0;     // Fraction of the nominal source power
+    double distance = 0.0;  // Path length covered, without weave (m)
+    bool on = false;        // False once the torch has finished its path
+};
+
+// Torch path evaluated in O(1) per time step.
+//
+// The constructor tabulates the start time, arc length and end of every
+// segment, and a bucket index from time to segment whose buckets are no
+// wider than the shortest segment (up to MAX_BUCKETS). at(t) then reads the
+// bucket, steps forward over at most one segment start, and places the
+// torch in closed form. With a linear speed ramp from v0 to v1 over duration T,
+// the distance along the segment is s(tau) = v0 tau + (v1 - v0) tau^2 / (2 T).
+// Without segments, the straight path of weld_direction is used exactly as
+// arcPosition() and arcOnPlate() define it.
+class TorchPath {
+public:
+    TorchPath() = default;
+
+    // Throws std::invalid_argument for degenerate segments, non-positive
+    // speeds or negative power fractions
+    explicit TorchPath(const SimulationConfig& config);
+
+    TorchState at(double t) const;
+
+    // Time at which the torch finishes its path (s); for the straight path,
+    // when it leaves the plate
+    double duration() const { return duration_; }
+
+    double length() const { return length_; }   // Path length without weave (m)
+    int segmentCount() const { return static_cast<int>(segments_.size()); }
+    bool straight() const { return segments_.empty(); }
+
+private:
+    struct Segment {
+        PathSegment::Kind kind;
+        double t0, T;           // Start time and duration (s)
+        double s0, L;           // Start arc length and length (m)
+        double v0, dv;          // Start speed and speed change (m/s)
+        double p0, dp;          // Start power fraction and change
+        double x0, y0;          // Line: start point; arc: centre
+        double ux, uy;          // Line: unit direction
+        double r, a0, turn;     // Arc: radius, start angle, +1 / -1 for ccw / cw
+    };
+
+    std::vector<Segment> segments_;
+    static constexpr int MAX_BUCKETS = 1 << 16;
+    std::vector<int> bucket_;    // Segment at the start of each time bucket
+    double bucket_width_ = 1.0;
+    double duration_ = 0.0;
+    double length_ = 0.0;
+    double weave_amplitude_ = 0.0;
+    double weave_omega_ = 0.0;   // rad/s
+
+    // Straight path (arcPosition() and arcOnPlate())
+    bool along_y_ = false;
+    double x_start_ = 0.0, y_arc_ = 0.0, v_weld_ = 0.0, Lx_ = 0.0, Ly_ = 0.0;
+
+    // Position and unit tangent at distance s into segment g
+    void place(const Segment& g, double s, double& x, double& y, double& tx, double& ty) const;
+};
+
+#endif // TORCH_PATH_H
@@ -0,0 +1,320 @@
+// Verification suite for the heat solver.
+//
+// Runs WeldingSimulation against exact solutions over sequences of grid and
+// time-step refinements, prints the errors and observed orders of accuracy,
+// and exits non-zero if an error, an order or the runtime falls outside its
+// threshold. Built as verify_welding and registered with CTest.
+//
+// Cases:
+//   diffusion-space  Gaussian pulse diffusing in a uniform plate, no source;
+//                    dx halved and dt quartered together (expected order 2)
+//   diffusion-time   Same pulse on a fixed grid with dt halved; order from
+//                    successive differences (expected order 1)
+//   rosenthal        Moving arc in a uniform plate compared with the
+//                    quasi-steady Rosenthal line-source solution away from
+//                    the source, on three grids
+//   ensemble         EnsembleSimulation lanes against the same variants run
+//                    one at a time; agreement is to rounding, not an order
+
+#include "WeldingSimulation.h"
+#include "EnsembleSimulation.h"
+#include "Rosenthal.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <omp.h>
+
+namespace {
+
+// Thresholds. Tightening them is fine; loosening one needs a reason.
+const double MIN_SPACE_ORDER = 1.8;
+const double MAX_SPACE_ERROR = 0.05;      // K, L2 error on the finest grid
+const double MIN_TIME_ORDER = 0.9;
+const double MAX_ROSENTHAL_ERROR = 0.06;  // Relative error of T - T0 on the finest grid
+const double MAX_ENSEMBLE_DIFF = 1e-6;    // K, ensemble lane vs. single run, T_final and T_max
+const double DEFAULT_TIME_BUDGET = 120.0; // s for the whole suite
+
+// Gaussian pulse: T = T0 + A s0^2 / s^2 exp(-r^2 / (2 s^2)), s^2 = s0^2 + 2 alpha t
+const double PULSE_AMPLITUDE = 100.0;     // K, stays below T_crit (constant properties)
+const double PULSE_SIGMA = 0.005;         // m
+const double PULSE_TIME = 2.0;            // s
+
+struct Check {
+    std::string name;
+    bool passed;
+    std::string detail;
+};
+
+std::vector<Check> checks;
+
+void check(const std::string& name, bool passed, const std::string& detail) {
+    checks.push_back({name, passed, detail});
+}
+
+std::string format(double value, int precision = 4) {
+    std::ostringstream ss;
+    ss << std::setprecision(precision) << value;
+    return ss.str();
+}
+
+// Both materials set to mild steel so the plate is uniform
+SimulationConfig uniformPlate() {
+    SimulationConfig c;
+    c.mat_2_name = c.mat_1_name;
+    c.mat_2_rho = c.mat_1_rho;
+    c.mat_2_cp = c.mat_1_cp;
+    c.mat_2_k = c.mat_1_k;
+    c.mat_2_T_melt = c.mat_1_T_melt;
+    c.mat_2_T_crit = c.mat_1_T_crit;
+    c.use_cache = false;
+    c.probes = {ProbeSpec{"centre", c.Lx / 2.0, 0.0, 1}};
+    return c;
+}
+
+double pulseExact(const SimulationConfig& c, double x, double y, double t) {
+    const double alpha = c.mat_1_k / (c.mat_1_rho * c.mat_1_cp);
+    const double s0_sq = PULSE_SIGMA * PULSE_SIGMA;
+    const double s_sq = s0_sq + 2.0 * alpha * t;
+    const double dx = x - c.Lx / 2.0;
+    return c.T0 + PULSE_AMPLITUDE * s0_sq / s_sq * std::exp(-(dx * dx + y * y) / (2.0 * s_sq));
+}
+
+// Diffuse the pulse for PULSE_TIME with `steps` steps; returns the final field
+std::vector<double> runPulse(int nx, int ny, int steps, double& seconds) {
+    SimulationConfig c = uniformPlate();
+    c.nx = nx;
+    c.ny = ny;
+    c.I = 0.0;  // No heat input
+    c.dt = PULSE_TIME / steps;
+    c.t_end = PULSE_TIME;
+
+    auto grid = makeGrid(c);
+    std::vector<double> T0(static_cast<size_t>(nx) * ny);
+    for (size_t k = 0; k < T0.size(); ++k) {
+        T0[k] = pulseExact(c, grid->X[k], grid->Y[k], 0.0);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    WeldingSimulation sim(c, grid, nullptr);
+    sim.setInitialTemperature(T0);
+    sim.run();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return sim.temperature();
+}
+
+// L2 (RMS) error of the pulse field against the exact solution
+double pulseError(int nx, int ny, const std::vector<double>& T) {
+    SimulationConfig c = uniformPlate();
+    c.nx = nx;
+    c.ny = ny;
+    auto grid = makeGrid(c);
+    double sum = 0.0;
+    for (size_t k = 0; k < T.size(); ++k) {
+        double e = T[k] - pulseExact(c, grid->X[k], grid->Y[k], PULSE_TIME);
+        sum += e * e;
+    }
+    return std::sqrt(sum / T.size());
+}
+
+void diffusionSpace(double& seconds_total) {
+    std::cout << "\n[diffusion-space] Gaussian pulse, dx/2 and dt/4 per level" << std::endl;
+    std::cout << std::setw(10) << "grid" << std::setw(10) << "dt" << std::setw(14) << "L2 error (K)"
+              << std::setw(10) << "order" << std::setw(10) << "time (s)" << std::endl;
+
+    const int levels[3][3] = {{61, 41, 20}, {121, 81, 80}, {241, 161, 320}};
+    double previous = 0.0, order = 0.0, error = 0.0;
+    for (int l = 0; l < 3; ++l) {
+        double seconds = 0.0;
+        std::vector<double> T = runPulse(levels[l][0], levels[l][1], levels[l][2], seconds);
+        seconds_total += seconds;
+        error = pulseError(levels[l][0], levels[l][1], T);
+        order = (l > 0) ? std::log2(previous / error) : 0.0;
+        previous = error;
+
+        std::cout << std::setw(10) << (std::to_string(levels[l][0]) + "x" + std::to_string(levels[l][1]))
+                  << std::setw(10) << format(PULSE_TIME / levels[l][2]) << std::setw(14) << format(error)
+                  << std::setw(10) << (l > 0 ? format(order, 3) : "-") << std::setw(10) << format(seconds, 3)
+                  << std::endl;
+    }
+    check("diffusion-space order", order >= MIN_SPACE_ORDER,
+          format(order, 3) + " (min " + format(MIN_SPACE_ORDER) + ")");
+    check("diffusion-space error", error <= MAX_SPACE_ERROR,
+          format(error) + " K (max " + format(MAX_SPACE_ERROR) + " K)");
+}
+
+void diffusionTime(double& seconds_total) {
+    std::cout << "\n[diffusion-time] Gaussian pulse on 121x81, dt/2 per level" << std::endl;
+    std::cout << std::setw(10) << "dt" << std::setw(18) << "|T - T_dt/2| (K)"
+              << std::setw(10) << "order" << std::setw(10) << "time (s)" << std::endl;
+
+    const int steps[4] = {80, 160, 320, 640};
+    std::vector<std::vector<double>> fields;
+    for (int s : steps) {
+        double seconds = 0.0;
+        fields.push_back(runPulse(121, 81, s, seconds));
+        seconds_total += seconds;
+    }
+
+    // Differences between successive levels shrink at the temporal order
+    double previous = 0.0, order = 0.0;
+    for (int l = 0; l + 1 < 4; ++l) {
+        double sum = 0.0;
+        for (size_t k = 0; k < fields[l].size(); ++k) {
+            double d = fields[l][k] - fields[l + 1][k];
+            sum += d * d;
+        }
+        double diff = std::sqrt(sum / fields[l].size());
+        order = (l > 0) ? std::log2(previous / diff) : 0.0;
+        previous = diff;
+        std::cout << std::setw(10) << format(PULSE_TIME / steps[l]) << std::setw(18) << format(diff)
+                  << std::setw(10) << (l > 0 ? format(order, 3) : "-") << std::endl;
+    }
+    check("diffusion-time order", order >= MIN_TIME_ORDER,
+          format(order, 3) + " (min " + format(MIN_TIME_ORDER) + ")");
+}
+
+void rosenthal(double& seconds_total) {
+    std::cout << "\n[rosenthal] Moving arc vs. quasi-steady line source, 6-14 mm from the weld line"
+              << std::endl;
+    std::cout << std::setw(10) << "grid" << std::setw(18) << "max rel. error"
+              << std::setw(10) << "time (s)" << std::endl;
+
+    // The arc runs 12 s and is then 72 mm from its start, far enough for
+    // the field 16-36 mm behind it to be quasi-steady. dt is below the
+    // explicit stability limit on every grid.
+    SimulationConfig base = uniformPlate();
+    base.dt = 0.005;
+    base.t_end = 12.0;
+
+    const double Q = processEfficiency(base) * base.V * base.I;
+    const double alpha = base.mat_1_k / (base.mat_1_rho * base.mat_1_cp);
+    double x_arc, y_arc;
+    arcPosition(base, base.t_end, x_arc, y_arc);
+
+    const int levels[3][2] = {{76, 51}, {151, 101}, {226, 151}};
+    double error = 0.0;
+    for (const auto& level : levels) {
+        SimulationConfig c = base;
+        c.nx = level[0];
+        c.ny = level[1];
+
+        auto start = std::chrono::steady_clock::now();
+        WeldingSimulation sim(c, nullptr, nullptr);
+        sim.run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        seconds_total += seconds;
+
+        // Sample on nodes shared by all grids (2 mm spacing)
+        auto grid = makeGrid(c);
+        const std::vector<double>& T = sim.temperature();
+        error = 0.0;
+        for (double xi : {-0.016, -0.026, -0.036}) {
+            for (double eta : {0.006, 0.010, 0.014}) {
+                int i = static_cast<int>(std::lround((x_arc + xi) / grid->dx));
+                int j = static_cast<int>(std::lround((eta + c.Ly / 2.0) / grid->dy));
+                double exact = rosenthalTemperature(Q, c.v_weld, c.thickness, c.mat_1_k, alpha,
+                                                    c.T0, grid->x[i] - x_arc, grid->y[j] - y_arc);
+                double rise = T[static_cast<size_t>(j) * c.nx + i] - c.T0;
+                error = std::max(error, std::fabs(rise - (exact - c.T0)) / (exact - c.T0));
+            }
+        }
+
+        std::cout << std::setw(10) << (std::to_string(c.nx) + "x" + std::to_string(c.ny))
+                  << std::setw(18) << format(error) << std::setw(10) << format(seconds, 3) << std::endl;
+    }
+    check("rosenthal error", error <= MAX_ROSENTHAL_ERROR,
+          format(error) + " (max " + format(MAX_ROSENTHAL_ERROR) + ")");
+}
+
+void ensemble(double& seconds_total) {
+    std::cout << "\n[ensemble] Ensemble lanes vs. single runs, 3 s of welding" << std::endl;
+    std::cout << std::setw(34) << "variant" << std::setw(18) << "max |dT| (K)" << std::endl;
+
+    // Two-material plate. At 5 mm/s the arc lands exactly on a node at
+    // t = 0.6 s, where the Goldak front/rear select is sensitive to rounding
+    // of the arc position.
+    SimulationConfig base;
+    base.use_cache = false;
+    base.t_end = 3.0;
+
+    std::vector<SimulationConfig> variants(4, base);
+    std::vector<std::string> names = {"default", "I 145 A, v 5 mm/s", "a 8 mm, b 4 mm",
+                                      "constant properties"};
+    variants[1].I = 145.0;
+    variants[1].v_weld = 0.005;
+    variants[2].a = 0.008;
+    variants[2].b = 0.004;
+    variants[3].constant_properties = true;
+
+    auto grid = makeGrid(base);
+    auto start = std::chrono::steady_clock::now();
+    EnsembleSimulation ens(variants, grid, nullptr);
+    ens.run();
+
+    double diff = 0.0;
+    for (size_t m = 0; m < variants.size(); ++m) {
+        WeldingSimulation sim(variants[m], grid, nullptr);
+        sim.run();
+
+        const std::vector<double> T = ens.temperature(static_cast<int>(m));
+        const std::vector<double> T_max = ens.peakTemperature(static_cast<int>(m));
+        double lane_diff = 0.0;
+        for (size_t k = 0; k < T.size(); ++k) {
+            lane_diff = std::max(lane_diff, std::fabs(T[k] - sim.temperature()[k]));
+            lane_diff = std::max(lane_diff, std::fabs(T_max[k] - sim.peakTemperature()[k]));
+        }
+        diff = std::max(diff, lane_diff);
+        std::cout << std::setw(34) << names[m] << std::setw(18) << format(lane_diff) << std::endl;
+    }
+    seconds_total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    check("ensemble vs. single", diff <= MAX_ENSEMBLE_DIFF,
+          format(diff) + " K (max " + format(MAX_ENSEMBLE_DIFF) + " K)");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double time_budget = DEFAULT_TIME_BUDGET;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--time_budget" && i + 1 < argc) {
+            time_budget = std::stod(argv[++i]);
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--time_budget <seconds>]" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::cout << "=== Welding Solver Verification ===" << std::endl;
+    std::cout << "OpenMP Max Threads: " << omp_get_max_threads() << std::endl;
+
+    double seconds = 0.0;
+    try {
+        diffusionSpace(seconds);
+        diffusionTime(seconds);
+        rosenthal(seconds);
+        ensemble(seconds);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    check("runtime", seconds <= time_budget,
+          format(seconds, 3) + " s (budget " + format(time_budget, 3) + " s)");
+
+    std::cout << "\n=== Summary ===" << std::endl;
+    int failed = 0;
+    for (const auto& c : checks) {
+        std::cout << (c.passed ? "  PASS  " : "  FAIL  ") << std::left << std::setw(24) << c.name
+                  << std::right << c.detail << std::endl;
+        failed += c.passed ? 0 : 1;
+    }
+    std::cout << (failed ? std::to_string(failed) + " check(s) failed" : "All checks passed") << std::endl;
+    return failed ? 1 : 0;
+}
@@ -1,12 +1,80 @@
 #include "WeldingSimulation.h"
+#include "HeatSource.h"
+#include "ResultCache.h"
+#include "Profiler.h"
 #include <cmath>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
 #include <chrono>
+#include <sstream>
+#include <stdexcept>
 #include <omp.h>
 
+namespace {
+
+void writePath(std::ostream& os, const TorchPathSpec& path) {
+    os << ";path=" << path.x0 << "," << path.y0
+       << ";weave=" << path.weave_amplitude << "," << path.weave_frequency;
+    for (const auto& s : path.segments) {
+        os << ";segment=" << (s.kind == PathSegment::Kind::Arc ? "arc" : "line") << ","
+           << s.x << "," << s.y << "," << s.sweep << "," << s.speed_start << "," << s.speed_end << ","
+           << s.power_start << "," << s.power_end;
+    }
+}
+
+} // namespace
+
+// Configuration hashing
+std::string canonicalConfig(const SimulationConfig& c) {
+    std::ostringstream os;
+    os << std::setprecision(17);
+    os << "Lx=" << c.Lx << ";Ly=" << c.Ly << ";thickness=" << c.thickness
+       << ";nx=" << c.nx << ";ny=" << c.ny
+       << ";mat_1=" << c.mat_1_name << "," << c.mat_1_rho << "," << c.mat_1_cp << ","
+       << c.mat_1_k << "," << c.mat_1_T_melt << "," << c.mat_1_T_crit
+       << ";mat_2=" << c.mat_2_name << "," << c.mat_2_rho << "," << c.mat_2_cp << ","
+       << c.mat_2_k << "," << c.mat_2_T_melt << "," << c.mat_2_T_crit
+       << ";V=" << c.V << ";I=" << c.I << ";eta=" << c.eta << ";v_weld=" << c.v_weld
+       << ";x_start=" << c.x_start << ";y_arc=" << c.y_arc << ";weld_direction=" << c.weld_direction
+       << ";goldak=" << c.a << "," << c.b << "," << c.cf << "," << c.cr << ","
+       << c.ff << "," << c.fr
+       << ";beam=" << c.Q_beam << "," << c.R_beam << "," << c.H_beam
+       << ";erw=" << c.erw_current_density << "," << c.erw_sigma_e << "," << c.erw_contact_width << ","
+       << c.erw_contact_resistance << "," << c.erw_melt_factor
+       << ";T0=" << c.T0 << ";h_conv=" << c.h_conv << ";dt=" << c.dt << ";theta=" << c.theta
+       << ";constant_properties=" << c.constant_properties
+       << ";t_end=" << c.t_end
+       << ";t85=" << c.T_t85_high << "," << c.T_t85_low
+       << ";weld_process=" << c.weld_process << ";use_gas=" << c.use_gas;
+    for (const auto& p : c.probes) {
+        os << ";probe=" << p.name << "," << p.x << "," << p.y << "," << p.interval;
+    }
+    if (!c.path.empty()) {
+        writePath(os, c.path);
+    }
+    for (const auto& s : c.sources) {
+        os << ";source=" << s.weld_process << "," << s.delay;
+        for (const auto& f : sourceFields()) {
+            os << "," << s.*f.source;
+        }
+        if (!s.path.empty()) {
+            writePath(os, s.path);
+        }
+    }
+    return os.str();
+}
+
+std::uint64_t configHash(const SimulationConfig& config) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char ch : canonicalConfig(config)) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 // Material implementation
 Material::Material(const std::string& name, double rho, double cp, double k,
                   double T_melt, double T_crit)
@@ -44,80 +112,324 @@ double Material::get_rho(double T) const {
     }
 }
 
+namespace {
+
+// Property laws: k, cp and rho of one material at T in one call, so the
+// interpolation fraction is computed once. materialKernel<Law> inlines the
+// law into its loops.
+
+// Temperature-dependent laws of Material::get_k, get_cp and get_rho
+struct PiecewiseLinearLaw {
+    double k, cp, rho, T_crit, T_melt;
+
+    void operator()(double T, double& k_out, double& cp_out, double& rho_out) const {
+        if (T < T_crit) {
+            k_out = k;
+            cp_out = cp;
+            rho_out = rho;
+        } else if (T < T_melt) {
+            const double frac = (T - T_crit) / (T_melt - T_crit);
+            k_out = k * (1.0 + frac * 0.1);
+            cp_out = cp * (1.0 + frac * 0.2);
+            rho_out = rho * (1.0 - frac * 0.05);
+        } else {
+            k_out = k * 1.1;
+            cp_out = cp * 1.2;
+            rho_out = rho * 0.95;
+        }
+    }
+};
+
+// Room-temperature values at every temperature (constant_properties)
+struct ConstantLaw {
+    double k, cp, rho, T_crit, T_melt;
+
+    void operator()(double, double& k_out, double& cp_out, double& rho_out) const {
+        k_out = k;
+        cp_out = cp;
+        rho_out = rho;
+    }
+};
+
+// Material 1 fills the first i_split columns of every row, material 2 the
+// rest, so no cell looks up its material
+template <class Law>
+void materialKernel(const Material& mat_1, const Material& mat_2, int nx, int ny, int i_split,
+                    const double* T, double* k, double* cp, double* rho) {
+    const Law law_1{mat_1.k, mat_1.cp, mat_1.rho, mat_1.T_crit, mat_1.T_melt};
+    const Law law_2{mat_2.k, mat_2.cp, mat_2.rho, mat_2.T_crit, mat_2.T_melt};
+
+    #pragma omp parallel for
+    for (int j = 0; j < ny; ++j) {
+        const int row = j * nx;
+        #pragma omp simd
+        for (int idx = row; idx < row + i_split; ++idx) {
+            law_1(T[idx], k[idx], cp[idx], rho[idx]);
+        }
+        #pragma omp simd
+        for (int idx = row + i_split; idx < row + nx; ++idx) {
+            law_2(T[idx], k[idx], cp[idx], rho[idx]);
+        }
+    }
+}
+
+} // namespace
+
+double processEfficiency(const SimulationConfig& config) {
+    if (config.weld_process == "TIG") {
+        return config.use_gas ? 0.75 : 0.65;
+    } else if (config.weld_process == "Electrode") {
+        return 0.85;
+    }
+    return config.eta;
+}
+
+const std::vector<SourceField>& sourceFields() {
+    using S = SourceSpec;
+    using C = SimulationConfig;
+    static const std::vector<SourceField> fields = {
+        {"V", &S::V, &C::V}, {"I", &S::I, &C::I}, {"eta", &S::eta, &C::eta},
+        {"a", &S::a, &C::a}, {"b", &S::b, &C::b}, {"ff", &S::ff, &C::ff}, {"fr", &S::fr, &C::fr},
+        {"Q_beam", &S::Q_beam, &C::Q_beam}, {"R_beam", &S::R_beam, &C::R_beam}, {"H_beam", &S::H_beam, &C::H_beam},
+    };
+    return fields;
+}
+
+SimulationConfig sourceConfig(const SimulationConfig& config, const SourceSpec& source) {
+    SimulationConfig c = config;
+    c.sources.clear();
+    if (!source.weld_process.empty()) {
+        c.weld_process = source.weld_process;
+    }
+    for (const auto& f : sourceFields()) {
+        if (!std::isnan(source.*f.source)) {
+            c.*f.config = source.*f.source;
+        }
+    }
+    if (!source.path.empty()) {
+        c.path = source.path;
+    }
+    return c;
+}
+
+double simulationEndTime(const SimulationConfig& config) {
+    if (config.t_end > 0) {
+        return config.t_end;
+    }
+    if (!config.sources.empty()) {
+        double t_end = 0.0;
+        for (const auto& s : config.sources) {
+            t_end = std::max(t_end, s.delay + simulationEndTime(sourceConfig(config, s)));
+        }
+        return t_end;
+    }
+    if (!config.path.segments.empty()) {
+        return TorchPath(config).duration() + 10.0;
+    }
+    if (config.weld_direction == "y") {
+        return config.Ly / config.v_weld + 10.0;
+    }
+    return (config.Lx - config.x_start) / config.v_weld + 10.0;
+}
+
+int timeStepCount(const SimulationConfig& config) {
+    return static_cast<int>(std::ceil(simulationEndTime(config) / config.dt));
+}
+
+void arcPosition(const SimulationConfig& config, double t, double& x_arc, double& y_arc) {
+    if (config.weld_direction == "y") {
+        x_arc = config.Lx / 2.0;
+        y_arc = -config.Ly / 2.0 + config.v_weld * t;
+    } else {
+        x_arc = config.x_start + config.v_weld * t;
+        y_arc = config.y_arc;
+    }
+}
+
+bool arcOnPlate(const SimulationConfig& config, double x_arc, double y_arc) {
+    if (config.weld_direction == "y") {
+        return y_arc >= -config.Ly / 2.0 && y_arc <= config.Ly / 2.0;
+    }
+    return x_arc <= config.Lx;
+}
+
+// Grid construction
+void validateConfig(const SimulationConfig& config) {
+    // The stencil needs an interior cell between two boundary cells
+    if (config.nx < 3 || config.ny < 3) {
+        throw std::invalid_argument("nx and ny must be at least 3");
+    }
+    if (!(config.Lx > 0.0 && config.Ly > 0.0 && config.thickness > 0.0 && config.dt > 0.0)) {
+        throw std::invalid_argument("Lx, Ly, thickness and dt must be positive");
+    }
+}
+
+namespace {
+
+const SimulationConfig& validated(const SimulationConfig& config) {
+    validateConfig(config);
+    return config;
+}
+
+} // namespace
+
+std::shared_ptr<const SimulationGrid> makeGrid(const SimulationConfig& config) {
+    validateConfig(config);
+    auto grid = std::make_shared<SimulationGrid>();
+    const int nx = config.nx;
+    const int ny = config.ny;
+
+    grid->nx = nx;
+    grid->ny = ny;
+    grid->Lx = config.Lx;
+    grid->Ly = config.Ly;
+    grid->x.resize(nx);
+    grid->y.resize(ny);
+    grid->X.resize(static_cast<size_t>(nx) * ny);
+    grid->Y.resize(static_cast<size_t>(nx) * ny);
+
+    // Create 1D grids
+    for (int i = 0; i < nx; ++i) {
+        grid->x[i] = i * config.Lx / (nx - 1);
+    }
+    for (int j = 0; j < ny; ++j) {
+        grid->y[j] = -config.Ly / 2.0 + j * config.Ly / (ny - 1);
+    }
+
+    grid->dx = grid->x[1] - grid->x[0];
+    grid->dy = grid->y[1] - grid->y[0];
+
+    // Create 2D meshgrid (row-major: Y varies with row, X with column)
+    #pragma omp parallel for collapse(2)
+    for (int j = 0; j < ny; ++j) {
+        for (int i = 0; i < nx; ++i) {
+            int index = j * nx + i;
+            grid->X[index] = grid->x[i];
+            grid->Y[index] = grid->y[j];
+        }
+    }
+
+    return grid;
+}
+
 // WeldingSimulation implementation
-WeldingSimulation::WeldingSimulation(const SimulationConfig& config)
-    : config_(config), nx_(config.nx), ny_(config.ny) {
+WeldingSimulation::WeldingSimulation(const SimulationConfig& config,
+                                     std::shared_ptr<const SimulationGrid> grid,
+                                     std::ostream* log)
+    : config_(validated(config)),
+      log_(log ? *log : null_log_),
+      grid_((grid && grid->matches(config)) ? std::move(grid) : makeGrid(config)),
+      nx_(config.nx), ny_(config.ny),
+      dx_(grid_->dx), dy_(grid_->dy),
+      x_(grid_->x), y_(grid_->y), X_(grid_->X), Y_(grid_->Y) {
 
     N_ = nx_ * ny_;
     midpoint_ = config_.Lx / 2.0;
 
+    if (config_.weld_direction != "x" && config_.weld_direction != "y") {
+        throw std::invalid_argument("Invalid weld_direction '" + config_.weld_direction + "'. Use 'x' or 'y'.");
+    }
+
+    if (config_.checkpoint_file.empty()) {
+        config_.checkpoint_file = outputPath("checkpoint.bin");
+    }
+
     // Adjust efficiency based on welding process
+    config_.eta = processEfficiency(config_);
     if (config_.weld_process == "TIG") {
-        std::cout << "Simulating TIG welding." << std::endl;
+        log_ << "Simulating TIG welding." << std::endl;
         if (config_.use_gas) {
-            std::cout << "Using shielding gas." << std::endl;
-            config_.eta = 0.75;
+            log_ << "Using shielding gas." << std::endl;
         } else {
-            std::cout << "Not using shielding gas." << std::endl;
-            config_.eta = 0.65;
+            log_ << "Not using shielding gas." << std::endl;
         }
     } else if (config_.weld_process == "Electrode") {
-        std::cout << "Simulating Electrode welding." << std::endl;
-        config_.eta = 0.85;
+        log_ << "Simulating Electrode welding." << std::endl;
         if (config_.use_gas) {
-            std::cout << "Warning: Gas is not typically used with electrode welding." << std::endl;
+            log_ << "Warning: Gas is not typically used with electrode welding." << std::endl;
         }
+    } else if (config_.weld_process == "Custom") {
+        log_ << "Simulating welding with arc efficiency " << config_.eta << "." << std::endl;
     }
 
-    Q_total_ = config_.eta * config_.V * config_.I;
+    if (config_.sources.empty()) {
+        torches_.push_back({makeHeatSource(config_), TorchPath(config_), 0.0});
+        if (!isGoldakProcess(config_.weld_process)) {
+            log_ << "Simulating " << torches_[0].source->name() << " welding with efficiency " << config_.eta << "."
+                 << std::endl;
+        }
+    } else {
+        // From the configuration as given, before the process presets above
+        for (size_t k = 0; k < config.sources.size(); ++k) {
+            const SourceSpec& s = config.sources[k];
+            try {
+                if (s.delay < 0.0) {
+                    throw std::invalid_argument("delay must not be negative");
+                }
+                const SimulationConfig c = sourceConfig(config, s);
+                torches_.push_back({makeHeatSource(c), TorchPath(c), s.delay});
+            } catch (const std::invalid_argument& e) {
+                throw std::invalid_argument("source " + std::to_string(k + 1) + ": " + e.what());
+            }
+        }
+    }
+    Q_total_ = 0.0;
+    for (const auto& torch : torches_) {
+        Q_total_ += torch.source->power();
+    }
 
-    initializeGrid();
     initializeMaterials();
     setupMonitoringPoints();
 
     // Calculate time parameters
-    t_end_ = (config_.Lx - config_.x_start) / config_.v_weld + 10.0;
-    nt_ = static_cast<int>(std::ceil(t_end_ / config_.dt));
+    t_end_ = simulationEndTime(config_);
+    nt_ = timeStepCount(config_);
+
+    // History buffers are sized once: the whole run, or one streaming chunk
+    std::vector<std::string> probe_names;
+    for (int k = 0; k < probes_.size(); ++k) {
+        probe_names.push_back(probes_.spec(k).name);
+    }
+    const int history_rows = nt_ / probes_.rowInterval() + 1;
+    history_.reset(probe_names, config_.history_chunk_rows > 0 ? config_.history_chunk_rows : history_rows);
 
     // Initialize temperature fields
     T_.resize(N_, config_.T0);
     T_max_.resize(N_, config_.T0);
-
-    std::cout << "Grid: " << nx_ << "x" << ny_ << ", Time steps: " << nt_ << std::endl;
-    std::cout << "Materials: " << mat_1_->name << " | " << mat_2_->name << std::endl;
-    std::cout << "Power: " << Q_total_ << "W, Speed: " << config_.v_weld * 1000.0 << "mm/s" << std::endl;
-}
-
-WeldingSimulation::~WeldingSimulation() = default;
-
-void WeldingSimulation::initializeGrid() {
-    x_.resize(nx_);
-    y_.resize(ny_);
-    X_.resize(N_);
-    Y_.resize(N_);
-
-    // Create 1D grids
-    for (int i = 0; i < nx_; ++i) {
-        x_[i] = i * config_.Lx / (nx_ - 1);
-    }
-    for (int j = 0; j < ny_; ++j) {
-        y_[j] = -config_.Ly / 2.0 + j * config_.Ly / (ny_ - 1);
-    }
-
-    dx_ = x_[1] - x_[0];
-    dy_ = y_[1] - y_[0];
-
-    // Create 2D meshgrid (row-major: Y varies with row, X with column)
-    #pragma omp parallel for collapse(2)
-    for (int j = 0; j < ny_; ++j) {
-        for (int i = 0; i < nx_; ++i) {
-            int index = idx(i, j);
-            X_[index] = x_[i];
-            Y_[index] = y_[j];
+    t_high_.resize(N_, -1.0);
+    t_low_.resize(N_, -1.0);
+    cool_rate_max_.resize(N_, 0.0);
+    time_above_crit_.resize(N_, 0.0);
+    zones_.reset(x_, y_, T_melt_, T_crit_, nt_);
+
+    log_ << "Grid: " << nx_ << "x" << ny_ << ", Time steps: " << nt_ << std::endl;
+    log_ << "Materials: " << mat_1_->name << " | " << mat_2_->name << std::endl;
+    log_ << "Power: " << Q_total_ << "W, Speed: " << config_.v_weld * 1000.0 << "mm/s" << std::endl;
+    if (torches_.size() > 1) {
+        for (size_t k = 0; k < torches_.size(); ++k) {
+            const Torch& torch = torches_[k];
+            log_ << "Source " << k + 1 << ": " << torch.source->name() << ", " << torch.source->power() << "W, "
+                 << torch.path.length() * 1000.0 << "mm path";
+            if (torch.delay > 0.0) {
+                log_ << " from t = " << torch.delay << "s";
+            }
+            log_ << std::endl;
         }
+    } else if (!torches_[0].path.straight()) {
+        const TorchPath& path = torches_[0].path;
+        log_ << "Torch path: " << path.segmentCount() << " segments, " << path.length() * 1000.0
+             << "mm in " << path.duration() << "s" << std::endl;
+    } else if (config_.weld_direction == "y") {
+        log_ << "Welding along y at the material interface" << std::endl;
+    }
+    if (config_.path.weave_amplitude > 0.0) {
+        log_ << "Weave: " << config_.path.weave_amplitude * 1000.0 << "mm at "
+             << config_.path.weave_frequency << "Hz" << std::endl;
     }
 }
 
+WeldingSimulation::~WeldingSimulation() = default;
+
 void WeldingSimulation::initializeMaterials() {
     mat_1_ = std::make_unique<Material>(
         config_.mat_1_name, config_.mat_1_rho, config_.mat_1_cp,
@@ -131,51 +443,32 @@ void WeldingSimulation::initializeMaterials() {
 
     T_melt_ = (mat_1_->T_melt + mat_2_->T_melt) / 2.0;
     T_crit_ = (mat_1_->T_crit + mat_2_->T_crit) / 2.0;
-}
 
-void WeldingSimulation::setupMonitoringPoints() {
-    // Three monitoring points: left, center, right
-    monitor_pts_ = {
-        {static_cast<int>(nx_ * 0.35), ny_ / 2},
-        {nx_ / 2, ny_ / 2},
-        {static_cast<int>(nx_ * 0.65), ny_ / 2}
+    static const MaterialKernel MATERIAL_KERNELS[] = {
+        materialKernel<PiecewiseLinearLaw>,
+        materialKernel<ConstantLaw>,
     };
-
-    T_history_.resize(monitor_pts_.size());
+    material_kernel_ = MATERIAL_KERNELS[config_.constant_properties ? 1 : 0];
+    i_split_ = static_cast<int>(std::lower_bound(x_.begin(), x_.end(), midpoint_) - x_.begin());
 }
 
-void WeldingSimulation::computeGoldakHeatFlux(double x_arc, std::vector<double>& q_surf) const {
-    const double a = config_.a;
-    const double b = config_.b;
-    const double cf = config_.cf;
-    const double cr = config_.cr;
-    const double ff = config_.ff;
-    const double fr = config_.fr;
-    const double y_arc = config_.y_arc;
-
-    const double a_sq = a * a;
-    const double b_sq = b * b;
-    const double coeff_f = (ff * Q_total_) / (a * b * M_PI);
-    const double coeff_r = (fr * Q_total_) / (a * b * M_PI);
-
-    q_surf.resize(N_);
-
-    // Parallelize with OpenMP
-    #pragma omp parallel for collapse(2)
-    for (int j = 0; j < ny_; ++j) {
-        for (int i = 0; i < nx_; ++i) {
-            int index = idx(i, j);
-            double xi = X_[index] - x_arc;
-            double eta = Y_[index] - y_arc;
-            double exp_arg = -xi * xi / a_sq - eta * eta / b_sq;
-
-            if (xi >= 0) {
-                q_surf[index] = coeff_f * std::exp(exp_arg);
-            } else {
-                q_surf[index] = coeff_r * std::exp(exp_arg);
-            }
+void WeldingSimulation::setupMonitoringPoints() {
+    std::vector<ProbeSpec> specs = config_.probes;
+
+    if (specs.empty()) {
+        // Three monitoring points on the centreline: left, center, right
+        const int pts[3] = {static_cast<int>(nx_ * 0.35), nx_ / 2, static_cast<int>(nx_ * 0.65)};
+        for (int k = 0; k < 3; ++k) {
+            ProbeSpec probe;
+            probe.name = "pt" + std::to_string(k + 1);
+            probe.x = x_[pts[k]];
+            probe.y = y_[ny_ / 2];
+            specs.push_back(probe);
         }
     }
+
+    probes_.setup(specs, x_, y_);
+    monitor_values_.resize(probes_.size());
 }
 
 void WeldingSimulation::computeMaterialProperties(const std::vector<double>& T_vec,
@@ -186,23 +479,38 @@ void WeldingSimulation::computeMaterialProperties(const std::vector<double>& T_v
     cp_arr.resize(N_);
     rho_arr.resize(N_);
 
-    // Parallelize material property computation
-    #pragma omp parallel for
-    for (int idx = 0; idx < N_; ++idx) {
-        const Material* mat = (X_[idx] < midpoint_) ? mat_1_.get() : mat_2_.get();
-        k_arr[idx] = mat->get_k(T_vec[idx]);
-        cp_arr[idx] = mat->get_cp(T_vec[idx]);
-        rho_arr[idx] = mat->get_rho(T_vec[idx]);
-    }
+    material_kernel_(*mat_1_, *mat_2_, nx_, ny_, i_split_, T_vec.data(),
+                     k_arr.data(), cp_arr.data(), rho_arr.data());
 }
 
 void WeldingSimulation::solveTimeStep(double t, const std::vector<double>& Qvol) {
     // Get material properties
-    std::vector<double> k_arr, cp_arr, rho_arr;
-    computeMaterialProperties(T_, k_arr, cp_arr, rho_arr);
+    {
+        WELD_PROFILE_SCOPE(Properties);
+        computeMaterialProperties(T_, k_arr_, cp_arr_, rho_arr_);
+    }
+
+    {
+        WELD_PROFILE_SCOPE(Stencil);
+        applyStencil(Qvol);
+    }
+
+    // Update temperature (every cell of T_new_ was written by the stencil)
+    T_.swap(T_new_);
+
+    // T_new_ now holds the previous step's field
+    WELD_PROFILE_SCOPE(Accumulators);
+    updateAccumulators(t, T_new_);
+}
 
-    // Create new temperature array
-    std::vector<double> T_new(N_);
+void WeldingSimulation::applyStencil(const std::vector<double>& Qvol) {
+    const std::vector<double>& k_arr = k_arr_;
+    const std::vector<double>& cp_arr = cp_arr_;
+    const std::vector<double>& rho_arr = rho_arr_;
+
+    // New temperature array (reused every step)
+    std::vector<double>& T_new = T_new_;
+    T_new.resize(N_);
 
     const double dt = config_.dt;
     const double theta = config_.theta;
@@ -258,133 +566,486 @@ void WeldingSimulation::solveTimeStep(double t, const std::vector<double>& Qvol)
             }
         }
     }
+}
 
-    // Update temperature
-    T_ = T_new;
+void WeldingSimulation::updateAccumulators(double t, const std::vector<double>& T_old) {
+    const double dt = config_.dt;
+    const double T_high = config_.T_t85_high;
+    const double T_low = config_.T_t85_low;
+    const double T_crit = T_crit_;
 
-    // Update maximum temperature
+    // Single fused pass: peak temperature, cooling rate, t8/5 crossings and
+    // time above T_crit all read the same two fields
     #pragma omp parallel for
     for (int idx = 0; idx < N_; ++idx) {
-        T_max_[idx] = std::max(T_max_[idx], T_[idx]);
+        const double T_now = T_[idx];
+        const double T_prev = T_old[idx];
+
+        T_max_[idx] = std::max(T_max_[idx], T_now);
+        cool_rate_max_[idx] = std::max(cool_rate_max_[idx], (T_prev - T_now) / dt);
+
+        if (T_now >= T_crit) {
+            time_above_crit_[idx] += dt;
+        }
+
+        // Crossing times are interpolated linearly within the step
+        if (t_high_[idx] < 0.0 && T_prev >= T_high && T_now < T_high) {
+            t_high_[idx] = t - dt * (T_high - T_now) / (T_prev - T_now);
+        }
+        if (t_high_[idx] >= 0.0 && t_low_[idx] < 0.0 && T_prev >= T_low && T_now < T_low) {
+            t_low_[idx] = t - dt * (T_low - T_now) / (T_prev - T_now);
+        }
+    }
+}
+
+TelemetryRecord WeldingSimulation::telemetryRecord(int step, double t) const {
+    TelemetryRecord record;
+    record.run = config_.output_dir;
+    record.step = step;
+    record.steps = nt_;
+    record.time = t;
+
+    // Current peak over the whole plate (the melt pool window is empty once
+    // the arc has left); one reduction per record
+    double T_peak = config_.T0;
+    #pragma omp parallel for reduction(max:T_peak)
+    for (int idx = 0; idx < N_; ++idx) {
+        T_peak = std::max(T_peak, T_[idx]);
+    }
+    record.T_peak = T_peak;
+
+    const std::vector<MeltPoolSample>& pool = zones_.samples();
+    if (!pool.empty()) {
+        record.pool_length = pool.back().length;
+        record.pool_width = pool.back().width;
+        record.pool_area = pool.back().area;
+    }
+
+    if (Profiler::instance().active()) {
+        for (const PhaseSummary& s : Profiler::instance().summary(false)) {
+            record.phases.emplace_back(profilePhaseName(s.phase), s.total);
+        }
     }
+    return record;
 }
 
-void WeldingSimulation::updateMonitoring(double t) {
-    time_history_.push_back(t);
+void WeldingSimulation::updateMonitoring(int step, double t) {
+    if (step % probes_.rowInterval() != 0) {
+        return;
+    }
+
+    probes_.sample(T_.data(), step, monitor_values_.data());
+    history_.record(t, monitor_values_.data());
+}
 
-    for (size_t k = 0; k < monitor_pts_.size(); ++k) {
-        int i = monitor_pts_[k].first;
-        int j = monitor_pts_[k].second;
-        int index = idx(i, j);
-        T_history_[k].push_back(T_[index]);
+void WeldingSimulation::restoreCheckpoint(const std::string& filename) {
+    restoreState(readCheckpointFile(filename), "Checkpoint " + filename);
+
+    log_ << "Restarted from " << filename << " at step " << start_step_
+              << " (t=" << start_time_ << "s)" << std::endl;
+}
+
+void WeldingSimulation::restoreState(CheckpointState state, const std::string& source) {
+    if (state.config_hash != configHash(config_)) {
+        throw std::runtime_error(source + " was written with a different configuration");
+    }
+    if (state.nx != nx_ || state.ny != ny_ ||
+        state.T.size() != static_cast<size_t>(N_) ||
+        state.T_max.size() != static_cast<size_t>(N_) ||
+        state.t_high.size() != static_cast<size_t>(N_) ||
+        state.t_low.size() != static_cast<size_t>(N_) ||
+        state.cool_rate_max.size() != static_cast<size_t>(N_) ||
+        state.time_above_crit.size() != static_cast<size_t>(N_) ||
+        state.history_series != static_cast<std::uint64_t>(probes_.size())) {
+        throw std::runtime_error(source + " does not match the grid");
     }
+    if ((state.history_stream_bytes > 0) != (config_.history_chunk_rows > 0)) {
+        throw std::runtime_error(source + " uses a different thermal history mode (--history_chunk)");
+    }
+    if (state.step < 0 || state.step > nt_) {
+        throw std::runtime_error(source + " has an invalid step count");
+    }
+
+    T_ = std::move(state.T);
+    T_max_ = std::move(state.T_max);
+    t_high_ = std::move(state.t_high);
+    t_low_ = std::move(state.t_low);
+    cool_rate_max_ = std::move(state.cool_rate_max);
+    time_above_crit_ = std::move(state.time_above_crit);
+    zones_.restoreState(state.fusion_words, state.crit_words, state.hot_box, state.melt_pool);
+    history_.restoreRows(state.history_time, state.history_values);
+    if (config_.history_chunk_rows > 0) {
+        history_.resumeStream(outputPath("thermal_history.csv"),
+                              state.history_stream_bytes, state.history_rows_streamed);
+    }
+    start_step_ = state.step;
+    start_time_ = state.time;
+    step_ = start_step_;
+    t_ = start_time_;
+}
+
+void WeldingSimulation::writeCheckpoint(int step, double t) {
+    // Skip rather than stall when the previous checkpoint is still being written
+    if (checkpoint_writer_.busy()) {
+        log_ << "Checkpoint at step " << step << " skipped (previous write pending)" << std::endl;
+        return;
+    }
+
+    checkpoint_writer_.submit(captureState(step, t), config_.checkpoint_file);
+}
+
+CheckpointState WeldingSimulation::captureState(int step, double t) const {
+    CheckpointState state;
+    state.config_hash = configHash(config_);
+    state.step = step;
+    state.time = t;
+    state.nx = nx_;
+    state.ny = ny_;
+    state.T = T_;
+    state.T_max = T_max_;
+    state.t_high = t_high_;
+    state.t_low = t_low_;
+    state.cool_rate_max = cool_rate_max_;
+    state.time_above_crit = time_above_crit_;
+    zones_.saveState(state.fusion_words, state.crit_words, state.hot_box, state.melt_pool);
+    state.history_series = history_.seriesCount();
+    history_.copyRows(state.history_time, state.history_values);
+    state.history_rows_streamed = history_.rowsStreamed();
+    state.history_stream_bytes = history_.streamBytes();
+    return state;
+}
+
+void WeldingSimulation::setInitialTemperature(const std::vector<double>& T) {
+    if (static_cast<int>(T.size()) != N_) {
+        throw std::invalid_argument("Initial temperature field has " + std::to_string(T.size()) +
+                                    " values, expected " + std::to_string(N_));
+    }
+    T_ = T;
+    T_max_ = T;
+    config_.use_cache = false;
 }
 
 void WeldingSimulation::run() {
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    double t = 0.0;
-    bool snapshot_taken = false;
-    int frame_counter = 0;
-    int frame_interval = 1;  // Save every N steps for video
+    startTelemetry();
+
+    // A profiled run must time the solver, not a cache load
+    const bool use_cache = config_.use_cache && ResultCache::cacheable(config_) && !Profiler::instance().active();
+    if (use_cache && loadCachedResult()) {
+        printStatistics();
+        return;
+    }
+
+    begin();
+    advance(nt_);
+    finish();
+
+    if (use_cache) {
+        storeCachedResult(t_);
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+    log_ << "Simulation completed in " << duration.count() / 1000.0 << "s" << std::endl;
+    if (PROFILING_COMPILED) {
+        Profiler::instance().printCounterSummary(log_);
+    }
+
+    printStatistics();
+}
+
+void WeldingSimulation::startTelemetry() {
+    if (!telemetry_ && !config_.telemetry_path.empty()) {
+        telemetry_ = std::make_unique<TelemetryPublisher>(config_.telemetry_path, config_.telemetry_hz);
+    }
+}
+
+void WeldingSimulation::begin() {
+    if (started_) {
+        throw std::logic_error("Simulation already started");
+    }
+    started_ = true;
+
+    startTelemetry();
+
+    if (!config_.restart_file.empty()) {
+        restoreCheckpoint(config_.restart_file);
+    }
+
+    if (config_.history_chunk_rows > 0 && !history_.streaming()) {
+        history_.openStream(outputPath("thermal_history.csv"));
+        log_ << "Thermal history streamed to " << history_.streamFile()
+                  << " every " << config_.history_chunk_rows << " rows" << std::endl;
+    }
+
+    step_ = start_step_;
+    t_ = start_time_;
+    snapshot_taken_ = config_.snapshot_time > 0 && t_ >= config_.snapshot_time;
+    frame_counter_ = 0;
+    frame_interval_ = 1;  // Save every N steps for video
 
     // Calculate frame interval based on desired FPS
     if (config_.save_video_frames && config_.video_frames_per_second > 0) {
         double time_per_frame = 1.0 / config_.video_frames_per_second;
-        frame_interval = std::max(1, static_cast<int>(time_per_frame / config_.dt));
-        std::cout << "Video frames will be saved every " << frame_interval << " steps" << std::endl;
+        frame_interval_ = std::max(1, static_cast<int>(time_per_frame / config_.dt));
+        frame_counter_ = start_step_ / frame_interval_;
+        log_ << "Video frames will be saved every " << frame_interval_ << " steps" << std::endl;
     }
 
-    std::cout << "Running simulation..." << std::endl;
-
-    for (int step = 1; step <= nt_; ++step) {
-        t += config_.dt;
-
-        // Update arc position
-        double x_arc = config_.x_start + config_.v_weld * t;
+    if (config_.checkpoint_interval > 0) {
+        log_ << "Checkpoints will be written to " << config_.checkpoint_file
+                  << " every " << config_.checkpoint_interval << " steps" << std::endl;
+    }
 
-        // Compute heat flux
-        std::vector<double> q_surf;
-        std::vector<double> Qvol(N_, 0.0);
+    log_ << "Running simulation..." << std::endl;
+}
 
-        if (x_arc <= config_.Lx) {
-            computeGoldakHeatFlux(x_arc, q_surf);
+int WeldingSimulation::advance(int n) {
+    if (!started_) {
+        begin();
+    }
 
-            // Convert surface flux to volumetric
-            #pragma omp parallel for
-            for (int idx = 0; idx < N_; ++idx) {
-                Qvol[idx] = q_surf[idx] / config_.thickness;
-            }
+    const int progress_interval = std::max(1, nt_ / 10);
+    const int last = step_ + std::max(0, std::min(n, nt_ - step_));
+    const int first = step_ + 1;
+    for (int step = first; step <= last; ++step) {
+        t_ += config_.dt;
+        const double t = t_;
+
+        // Compute the volumetric heat source
+        CellWindow source_box;
+        {
+            WELD_PROFILE_SCOPE(HeatFlux);
+            source_box = computeSourceTerm(t);
         }
 
         // Solve time step
-        solveTimeStep(t, Qvol);
+        solveTimeStep(t, Qvol_);
+        step_ = step;
+
+        // Update zones and melt pool geometry around the sources
+        {
+            WELD_PROFILE_SCOPE(Zones);
+            zones_.update(t, T_.data(), source_box);
+        }
 
         // Update monitoring
-        updateMonitoring(t);
+        {
+            WELD_PROFILE_SCOPE(Monitoring);
+            updateMonitoring(step, t);
+        }
 
         // Save video frame
-        if (config_.save_video_frames && (step % frame_interval == 0 || step == nt_)) {
-            exportVideoFrame(frame_counter, t);
-            frame_counter++;
+        if (config_.save_video_frames && (step % frame_interval_ == 0 || step == nt_)) {
+            WELD_PROFILE_SCOPE(FrameExport);
+            exportVideoFrame(frame_counter_, t);
+            frame_counter_++;
         }
 
         // Snapshot
-        if (config_.snapshot_time > 0 && t >= config_.snapshot_time && !snapshot_taken) {
-            std::cout << "Taking snapshot at t=" << t << "s" << std::endl;
+        if (config_.snapshot_time > 0 && t >= config_.snapshot_time && !snapshot_taken_) {
+            WELD_PROFILE_SCOPE(Snapshot);
+            log_ << "Taking snapshot at t=" << t << "s" << std::endl;
             exportResults("_snapshot_" + std::to_string(static_cast<int>(t)) + "s");
-            snapshot_taken = true;
+            snapshot_taken_ = true;
+        }
+
+        // Checkpoint
+        if (config_.checkpoint_interval > 0 && step % config_.checkpoint_interval == 0 && step < nt_) {
+            WELD_PROFILE_SCOPE(Checkpoint);
+            writeCheckpoint(step, t);
         }
 
         // Progress indicator
-        if (step % (nt_ / 10) == 0 || step == nt_) {
-            std::cout << "Progress: " << (100 * step / nt_) << "%" << std::endl;
+        if (step % progress_interval == 0 || step == nt_) {
+            log_ << "Progress: " << (100 * step / nt_) << "%" << std::endl;
+        }
+
+        // Live telemetry (skipped while the publisher is busy)
+        if (telemetry_ && telemetry_->due()) {
+            telemetry_->post(telemetryRecord(step, t));
         }
     }
+    return last - first + 1;
+}
 
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+void WeldingSimulation::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
 
-    std::cout << "Simulation completed in " << duration.count() / 1000.0 << "s" << std::endl;
+    history_.flush();
+    checkpoint_writer_.wait();
 
-    printStatistics();
+    if (telemetry_) {
+        TelemetryRecord record = telemetryRecord(step_, t_);
+        record.done = true;
+        telemetry_->finish(record);
+        telemetry_.reset();
+    }
 }
 
-void WeldingSimulation::computeZones(std::vector<bool>& fusion_zone,
-                                    std::vector<bool>& HAZ_zone) const {
-    fusion_zone.resize(N_);
-    HAZ_zone.resize(N_);
+bool WeldingSimulation::loadCachedResult() {
+    ResultCache cache(config_.cache_dir, config_.cache_max_mb);
+    const std::string key = ResultCache::key(config_);
 
-    #pragma omp parallel for
-    for (int idx = 0; idx < N_; ++idx) {
-        fusion_zone[idx] = (T_max_[idx] >= T_melt_);
-        HAZ_zone[idx] = (T_max_[idx] >= T_crit_ && T_max_[idx] < T_melt_);
+    CheckpointState state;
+    try {
+        if (!cache.load(config_, state) || state.step != nt_) {
+            return false;
+        }
+        restoreState(std::move(state), "Cache entry " + key);
+    } catch (const std::exception& e) {
+        log_ << "Warning: ignoring cache entry " << key << ": " << e.what() << std::endl;
+        return false;
     }
+
+    log_ << "Loaded cached result " << key << " from " << cache.directory()
+         << " (run without --cache to recompute)" << std::endl;
+    return true;
 }
 
-void WeldingSimulation::printStatistics() const {
-    // Find maximum temperature
-    double T_peak = *std::max_element(T_max_.begin(), T_max_.end());
+void WeldingSimulation::storeCachedResult(double t) const {
+    ResultCache cache(config_.cache_dir, config_.cache_max_mb);
+    try {
+        cache.store(config_, captureState(nt_, t));
+    } catch (const std::exception& e) {
+        log_ << "Warning: result not cached: " << e.what() << std::endl;
+    }
+}
 
-    // Compute zones
-    std::vector<bool> fusion_zone, HAZ_zone;
-    computeZones(fusion_zone, HAZ_zone);
+CellWindow WeldingSimulation::sourceWindow(const HeatSource& source, double x_src, double y_src) const {
+    double reach_x, reach_y;
+    source.reach(reach_x, reach_y);
 
-    int fusion_count = std::count(fusion_zone.begin(), fusion_zone.end(), true);
-    int HAZ_count = std::count(HAZ_zone.begin(), HAZ_zone.end(), true);
+    CellWindow w;
+    w.i0 = std::max(0, static_cast<int>(std::floor((x_src - reach_x - x_[0]) / dx_)));
+    w.i1 = std::min(nx_ - 1, static_cast<int>(std::ceil((x_src + reach_x - x_[0]) / dx_)));
+    w.j0 = std::max(0, static_cast<int>(std::floor((y_src - reach_y - y_[0]) / dy_)));
+    w.j1 = std::min(ny_ - 1, static_cast<int>(std::ceil((y_src + reach_y - y_[0]) / dy_)));
+    return w;
+}
+
+CellWindow WeldingSimulation::computeSourceTerm(double t) {
+    std::vector<double>& Qvol = Qvol_;
+    if (Qvol.size() != static_cast<size_t>(N_)) {
+        Qvol.assign(N_, 0.0);
+        source_windows_.clear();
+    }
+
+    // Only the cells written last step are non-zero
+    for (const CellWindow& w : source_windows_) {
+        for (int j = w.j0; j <= w.j1; ++j) {
+            std::fill(Qvol.begin() + idx(w.i0, j), Qvol.begin() + idx(w.i1, j) + 1, 0.0);
+        }
+    }
+    source_windows_.clear();
 
+    // Torches on their paths, each with its window
+    struct Active {
+        const HeatSource* source;
+        TorchState state;
+        CellWindow window;
+    };
+    std::vector<Active> active;
+    CellWindow box;
+    box.i0 = nx_; box.i1 = -1; box.j0 = ny_; box.j1 = -1;
+    for (auto& torch : torches_) {
+        if (t < torch.delay) {
+            continue;
+        }
+        const TorchState state = torch.path.at(t - torch.delay);
+        if (!state.on) {
+            continue;
+        }
+        const CellWindow w = sourceWindow(*torch.source, state.x, state.y);
+        if (w.empty()) {
+            continue;
+        }
+        torch.source->update(T_);
+        active.push_back({torch.source.get(), state, w});
+        source_windows_.push_back(w);
+        box.i0 = std::min(box.i0, w.i0);
+        box.i1 = std::max(box.i1, w.i1);
+        box.j0 = std::min(box.j0, w.j0);
+        box.j1 = std::max(box.j1, w.j1);
+    }
+    if (active.empty()) {
+        return CellWindow();
+    }
+
+    // Each thread owns a band of rows and adds every source that overlaps
+    // it, in source order: overlapping windows need no atomics, and the sum
+    // does not depend on the thread count
+    const int band = 4;
+    const int bands = (box.j1 - box.j0) / band + 1;
+    double* Q = Qvol.data();
+    const SimulationGrid& grid = *grid_;
+
+    #pragma omp parallel for schedule(static) if (bands > 1)
+    for (int b = 0; b < bands; ++b) {
+        const int j0 = box.j0 + b * band;
+        const int j1 = std::min(box.j1, j0 + band - 1);
+        for (const Active& a : active) {
+            CellWindow w = a.window;
+            w.j0 = std::max(w.j0, j0);
+            w.j1 = std::min(w.j1, j1);
+            if (!w.empty()) {
+                a.source->accumulate(grid, a.state.x, a.state.y, a.state.power, w, Q);
+            }
+        }
+    }
+    return box;
+}
+
+SimulationStatistics WeldingSimulation::statistics() const {
+    SimulationStatistics stats;
+
+    // Find maximum temperature
+    stats.T_peak = *std::max_element(T_max_.begin(), T_max_.end());
+
+    // Zones are tracked incrementally during the run
     double cell_area = dx_ * dy_;
-    double fusion_area = fusion_count * cell_area;
-    double HAZ_area = HAZ_count * cell_area;
+    stats.fusion_area = zones_.fusionCount() * cell_area;
+    stats.HAZ_area = zones_.HAZCount() * cell_area;
+
+    stats.peak_cooling_rate = *std::max_element(cool_rate_max_.begin(), cool_rate_max_.end());
+    for (int idx = 0; idx < N_; ++idx) {
+        if (t_low_[idx] >= 0.0) {
+            double t85 = t_low_[idx] - t_high_[idx];
+            stats.t85_min = (stats.t85_min < 0.0) ? t85 : std::min(stats.t85_min, t85);
+            stats.t85_max = std::max(stats.t85_max, t85);
+        }
+    }
 
-    std::cout << "\n=== Simulation Results ===" << std::endl;
-    std::cout << "Peak Temperature: " << T_peak << " K" << std::endl;
-    std::cout << "Fusion Zone Area: " << fusion_area * 1e6 << " mm²" << std::endl;
-    std::cout << "HAZ Area: " << HAZ_area * 1e6 << " mm²" << std::endl;
+    return stats;
+}
+
+void WeldingSimulation::printStatistics() const {
+    SimulationStatistics stats = statistics();
+
+    log_ << "\n=== Simulation Results ===" << std::endl;
+    log_ << "Peak Temperature: " << stats.T_peak << " K" << std::endl;
+    log_ << "Fusion Zone Area: " << stats.fusion_area * 1e6 << " mm²" << std::endl;
+    log_ << "HAZ Area: " << stats.HAZ_area * 1e6 << " mm²" << std::endl;
+
+    log_ << "Peak Cooling Rate: " << stats.peak_cooling_rate << " K/s" << std::endl;
+    if (stats.t85_min >= 0.0) {
+        log_ << "t8/5 Range: " << stats.t85_min << " - " << stats.t85_max << " s" << std::endl;
+    } else {
+        log_ << "t8/5 Range: not reached (no cell cooled through both thresholds)" << std::endl;
+    }
+}
+
+std::string WeldingSimulation::outputPath(const std::string& name) const {
+    return config_.output_dir + "/" + name;
 }
 
 void WeldingSimulation::exportResults(const std::string& prefix) const {
-    std::string filename = "output/simulation_results" + prefix + ".csv";
+    std::string filename = outputPath("simulation_results" + prefix + ".csv");
 
     std::ofstream file(filename);
     if (!file.is_open()) {
@@ -394,49 +1055,61 @@ void WeldingSimulation::exportResults(const std::string& prefix) const {
 
     file << std::setprecision(6) << std::fixed;
 
-    // Write header
-    file << "i,j,x,y,T_final,T_max" << std::endl;
+    // Write header (t8_5 is -1 where the cell never cooled through both thresholds)
+    file << "i,j,x,y,T_final,T_max,t8_5,cooling_rate_max,time_above_crit" << std::endl;
 
     // Write data
     for (int j = 0; j < ny_; ++j) {
         for (int i = 0; i < nx_; ++i) {
             int index = idx(i, j);
+            double t85 = (t_low_[index] >= 0.0) ? t_low_[index] - t_high_[index] : -1.0;
             file << i << "," << j << ","
                  << x_[i] << "," << y_[j] << ","
-                 << T_[index] << "," << T_max_[index] << std::endl;
+                 << T_[index] << "," << T_max_[index] << ","
+                 << t85 << "," << cool_rate_max_[index] << ","
+                 << time_above_crit_[index] << std::endl;
         }
     }
 
     file.close();
 
     // Export thermal history
-    std::string history_file = "output/thermal_history" + prefix + ".csv";
-    std::ofstream hist_file(history_file);
+    std::string history_file = outputPath("thermal_history" + prefix + ".csv");
 
-    if (hist_file.is_open()) {
-        hist_file << std::setprecision(6) << std::fixed;
-        hist_file << "time";
-        for (size_t k = 0; k < monitor_pts_.size(); ++k) {
-            hist_file << ",T_pt" << k + 1;
-        }
-        hist_file << std::endl;
+    if (history_.streaming()) {
+        // The streamed file is the complete history; snapshots do not duplicate it
+        history_file = history_.streamFile();
+    } else {
+        std::ofstream hist_file(history_file);
 
-        for (size_t t = 0; t < time_history_.size(); ++t) {
-            hist_file << time_history_[t];
-            for (size_t k = 0; k < monitor_pts_.size(); ++k) {
-                hist_file << "," << T_history_[k][t];
-            }
-            hist_file << std::endl;
+        if (hist_file.is_open()) {
+            history_.writeCsv(hist_file);
+            hist_file.close();
         }
-        hist_file.close();
     }
 
-    std::cout << "Results exported to " << filename << " and " << history_file << std::endl;
+    // Export melt pool time series and packed zone map
+    std::string melt_pool_file = outputPath("melt_pool" + prefix + ".csv");
+    std::ofstream pool_file(melt_pool_file);
+    if (pool_file.is_open()) {
+        zones_.writeMeltPoolCsv(pool_file);
+        pool_file.close();
+    }
+
+    std::string zone_map_file = outputPath("zone_map" + prefix + ".bin");
+    std::ofstream map_file(zone_map_file, std::ios::binary);
+    if (map_file.is_open()) {
+        zones_.writeZoneMap(map_file);
+        map_file.close();
+    }
+
+    log_ << "Results exported to " << filename << " and " << history_file << std::endl;
+    log_ << "Melt pool series: " << melt_pool_file << ", zone map: " << zone_map_file << std::endl;
 }
 
 void WeldingSimulation::exportVideoFrame(int frame_number, double current_time) {
-    std::string filename = "output/video_frames/frame_" +
-                          std::to_string(frame_number) + ".csv";
+    std::string filename = outputPath("video_frames/frame_" +
+                                     std::to_string(frame_number) + ".csv");
 
     std::ofstream file(filename);
     if (!file.is_open()) {
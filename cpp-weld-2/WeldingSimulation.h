@@ -4,6 +4,35 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdint>
+#include <ostream>
+#include <iostream>
+#include <limits>
+
+#include "Checkpoint.h"
+#include "ThermalHistory.h"
+#include "ProbeSet.h"
+#include "ZoneTracker.h"
+#include "Telemetry.h"
+#include "TorchPath.h"
+
+// One of several simultaneous heat sources (tandem or twin-torch welding).
+// Unset fields (NaN, empty process or path) take the run's value.
+struct SourceSpec {
+    std::string weld_process;
+    double V = std::numeric_limits<double>::quiet_NaN();
+    double I = std::numeric_limits<double>::quiet_NaN();
+    double eta = std::numeric_limits<double>::quiet_NaN();
+    double a = std::numeric_limits<double>::quiet_NaN();
+    double b = std::numeric_limits<double>::quiet_NaN();
+    double ff = std::numeric_limits<double>::quiet_NaN();
+    double fr = std::numeric_limits<double>::quiet_NaN();
+    double Q_beam = std::numeric_limits<double>::quiet_NaN();
+    double R_beam = std::numeric_limits<double>::quiet_NaN();
+    double H_beam = std::numeric_limits<double>::quiet_NaN();
+    double delay = 0.0;        // The source starts its path this long after the run (s)
+    TorchPathSpec path;
+};
 
 // Configuration structure for simulation parameters
 struct SimulationConfig {
@@ -37,6 +66,9 @@ struct SimulationConfig {
     double v_weld = 0.006;     // Welding velocity (m/s)
     double x_start = 0.02;     // Starting position (m)
     double y_arc = 0.0;        // Arc position in y (m)
+    std::string weld_direction = "x";  // 'x', or 'y' along the interface from y = -Ly/2
+    TorchPathSpec path;        // Segments, ramps and weave (empty = straight along weld_direction)
+    std::vector<SourceSpec> sources;  // Simultaneous sources (empty = the one source above)
 
     // Goldak double ellipsoid parameters
     double a = 0.005;          // Semi-axis in x (m)
@@ -46,20 +78,133 @@ struct SimulationConfig {
     double ff = 0.6;           // Front fraction
     double fr = 1.4;           // Rear fraction
 
+    // Beam and resistance sources (see HeatSource.h)
+    double Q_beam = 3000.0;    // Beam power (W, EBW and LBW)
+    double R_beam = 0.001;     // Beam / plasma column radius (m, EBW, LBW and PAW)
+    double H_beam = 0.006;     // Penetration depth (m, EBW and PAW)
+    double erw_current_density = 8e6;      // Peak current density (A/m²)
+    double erw_sigma_e = 4.5e6;            // Electrical conductivity (S/m)
+    double erw_contact_width = 0.005;      // Contact zone width (m)
+    double erw_contact_resistance = 1e-6;  // Contact resistance below 0.8 T_melt (Ω·m²)
+    double erw_melt_factor = 0.1;          // Fraction of it left at T_melt
+
     // Simulation parameters
     double T0 = 293.0;         // Ambient temperature (K)
     double h_conv = 20.0;      // Convection coefficient (W/m²·K)
     double dt = 0.02;          // Time step (s)
     double theta = 0.5;        // Crank-Nicolson parameter (0.5 = centered)
+    bool constant_properties = false;  // Room-temperature k, cp, rho at every temperature
+    double t_end = -1.0;       // Simulated time (s, -1 = until the arc leaves plus 10 s)
+
+    // Cooling metrics
+    double T_t85_high = 1073.15;       // Upper t8/5 threshold (K, 800 °C)
+    double T_t85_low = 773.15;         // Lower t8/5 threshold (K, 500 °C)
 
     // Process parameters
-    std::string weld_process = "TIG";  // TIG or Electrode
+    std::string weld_process = "TIG";  // TIG, Electrode, Custom (uses eta), EBW, LBW, PAW, SAW or ERW
     bool use_gas = true;
     double snapshot_time = -1.0;       // Time for snapshot (-1 = disabled)
 
     // Video generation parameters
     bool save_video_frames = false;    // Enable video frame saving
     int video_frames_per_second = 10;  // FPS for video output
+
+    // Output location
+    std::string output_dir = "output"; // Directory for all result files
+
+    // Checkpoint / restart parameters
+    int checkpoint_interval = 0;       // Steps between checkpoints (0 = disabled)
+    std::string checkpoint_file;       // Checkpoint path (empty = <output_dir>/checkpoint.bin)
+    std::string restart_file;          // Checkpoint to resume from (empty = fresh start)
+
+    // Monitoring probes (empty = three centreline points at 35%/50%/65% of x)
+    std::vector<ProbeSpec> probes;
+
+    // Thermal history output
+    int history_chunk_rows = 0;        // Stream history to disk every N rows (0 = keep in memory)
+
+    // Live telemetry (newline-delimited JSON)
+    std::string telemetry_path;        // Unix domain socket or FIFO (empty = disabled)
+    double telemetry_hz = 2.0;         // Records per second
+
+    // Result cache
+    bool use_cache = false;            // Reuse results of identical earlier runs (opt in: --cache)
+    std::string cache_dir = ".weld_cache";
+    double cache_max_mb = 512.0;       // Least recently used entries are evicted above this
+};
+
+// Identifies the numerical scheme. Bump it whenever a change alters results,
+// so cached results from older builds are not reused.
+const char* const SOLVER_VERSION = "3";
+
+// SourceSpec number fields and the SimulationConfig members they override
+struct SourceField {
+    const char* key;
+    double SourceSpec::* source;
+    double SimulationConfig::* config;
+};
+const std::vector<SourceField>& sourceFields();
+
+// Configuration of one source: config with the fields set in `source`
+// applied, and no sources of its own
+SimulationConfig sourceConfig(const SimulationConfig& config, const SourceSpec& source);
+
+// Canonical text form of the parameters that determine the solution
+// (output and checkpoint options are excluded)
+std::string canonicalConfig(const SimulationConfig& config);
+
+// 64-bit FNV-1a hash of canonicalConfig()
+std::uint64_t configHash(const SimulationConfig& config);
+
+// Efficiency implied by the process (TIG/Electrode presets, the others use config.eta)
+double processEfficiency(const SimulationConfig& config);
+
+// Simulated time: config.t_end if set, else until the arc leaves the plate
+// (or finishes config.path; with config.sources, until the last source
+// finishes) plus 10 s of cooling
+double simulationEndTime(const SimulationConfig& config);
+
+// Number of time steps covering simulationEndTime()
+int timeStepCount(const SimulationConfig& config);
+
+// Arc centre at time t on the straight path (config.path is ignored; see
+// TorchPath). Along x it starts at (x_start, y_arc); along y it starts at
+// (Lx/2, -Ly/2) and follows the material interface.
+void arcPosition(const SimulationConfig& config, double t, double& x_arc, double& y_arc);
+
+// Whether the arc is still on the plate (heat input stops once it leaves)
+bool arcOnPlate(const SimulationConfig& config, double x_arc, double y_arc);
+
+// Tensor-product grid; read-only, so runs with the same geometry share it
+struct SimulationGrid {
+    int nx = 0, ny = 0;
+    double Lx = 0.0, Ly = 0.0;
+    double dx = 0.0, dy = 0.0;
+    std::vector<double> x, y;
+    std::vector<double> X, Y;  // Meshgrid (row-major)
+
+    bool matches(const SimulationConfig& config) const {
+        return nx == config.nx && ny == config.ny && Lx == config.Lx && Ly == config.Ly;
+    }
+};
+
+// Throws std::invalid_argument unless nx, ny >= 3 and Lx, Ly, thickness and
+// dt are positive. makeGrid() and the WeldingSimulation constructor call it,
+// so every front end (CLI, config files, batches, sweeps, server, C API) is
+// covered.
+void validateConfig(const SimulationConfig& config);
+
+// Build the grid described by config (nx, ny, Lx, Ly)
+std::shared_ptr<const SimulationGrid> makeGrid(const SimulationConfig& config);
+
+// Summary numbers printed at the end of a run
+struct SimulationStatistics {
+    double T_peak = 0.0;             // K
+    double fusion_area = 0.0;        // m²
+    double HAZ_area = 0.0;           // m²
+    double peak_cooling_rate = 0.0;  // K/s
+    double t85_min = -1.0;           // s (-1 = no cell cooled through both thresholds)
+    double t85_max = -1.0;           // s
 };
 
 // Material class
@@ -82,85 +227,216 @@ public:
     double get_rho(double T) const;
 };
 
+class HeatSource;
+
 // Main simulation class
 class WeldingSimulation {
+    // Microbenchmarks drive the private kernels directly
+    friend class KernelBenchmark;
+
 public:
-    WeldingSimulation(const SimulationConfig& config);
+    // A shared grid is used when it matches the configuration; progress
+    // messages go to `log` (nullptr = silent)
+    WeldingSimulation(const SimulationConfig& config,
+                      std::shared_ptr<const SimulationGrid> grid = nullptr,
+                      std::ostream* log = &std::cout);
     ~WeldingSimulation();
 
     // Run the simulation
     void run();
 
+    // Incremental alternative to run(), e.g. for library callers that read
+    // the fields between steps. begin() sets up the time loop like run()
+    // (restart, history stream, telemetry) but never consults the result
+    // cache; advance() runs up to n more steps (calling begin() if needed)
+    // and returns the number run, 0 once the end time is reached; finish()
+    // flushes history, checkpoints and telemetry.
+    void begin();
+    int advance(int n);
+    void finish();
+
+    int currentStep() const { return step_; }    // Last completed step
+    int totalSteps() const { return nt_; }
+    double currentTime() const { return t_; }    // Simulation time (s)
+
     // Export results
     void exportResults(const std::string& prefix = "") const;
 
     // Export video frame (called during simulation)
     void exportVideoFrame(int frame_number, double current_time);
 
+    // Restore solver state from a checkpoint written by a previous run
+    void restoreCheckpoint(const std::string& filename);
+
+    // Peak temperature, zone areas and cooling metrics of the current state
+    SimulationStatistics statistics() const;
+
+    // Monitoring probe history (rows still in memory when streaming)
+    const ThermalHistory& history() const { return history_; }
+
+    // Replace the uniform T0 start with `T` (row-major, one value per cell)
+    // before run(), e.g. for manufactured solutions. The result cache is
+    // bypassed since the field is not part of the configuration.
+    void setInitialTemperature(const std::vector<double>& T);
+
+    // Current temperature field (row-major, K)
+    const std::vector<double>& temperature() const { return T_; }
+
+    // Peak temperature reached at every cell so far (row-major, K)
+    const std::vector<double>& peakTemperature() const { return T_max_; }
+
+    const SimulationConfig& config() const { return config_; }
+    const SimulationGrid& grid() const { return *grid_; }
+
 private:
     SimulationConfig config_;
     std::unique_ptr<Material> mat_1_;
     std::unique_ptr<Material> mat_2_;
 
-    // Grid
+    // Property kernel of the material law, from a table of one
+    // instantiation per law (temperature-dependent or constant)
+    using MaterialKernel = void (*)(const Material& mat_1, const Material& mat_2, int nx, int ny, int i_split,
+                                    const double* T, double* k, double* cp, double* rho);
+    MaterialKernel material_kernel_ = nullptr;
+    int i_split_ = 0;   // Columns with x < Lx/2 (material 1)
+
+    // Progress output
+    std::ostream null_log_{nullptr};
+    std::ostream& log_;
+
+    // Grid (possibly shared with other simulations)
+    std::shared_ptr<const SimulationGrid> grid_;
     int nx_, ny_, N_;
     double dx_, dy_;
     double midpoint_;
-    std::vector<double> x_, y_;
-    std::vector<double> X_, Y_;  // Meshgrid (row-major)
+    const std::vector<double>& x_;
+    const std::vector<double>& y_;
+    const std::vector<double>& X_;  // Meshgrid (row-major)
+    const std::vector<double>& Y_;
 
     // Temperature fields
     std::vector<double> T_;      // Current temperature
     std::vector<double> T_max_;  // Peak temperature
 
+    // Per-cell cooling accumulators, updated every step
+    std::vector<double> t_high_;           // First cooling crossing of T_t85_high (s, -1 = none)
+    std::vector<double> t_low_;            // First cooling crossing of T_t85_low after it (s, -1 = none)
+    std::vector<double> cool_rate_max_;    // Running max of -dT/dt (K/s)
+    std::vector<double> time_above_crit_;  // Time spent at or above T_crit (s)
+
+    // Fusion/HAZ zones and melt pool time series
+    ZoneTracker zones_;
+
+    // Per-step scratch buffers, kept across steps to avoid reallocation
+    std::vector<double> T_new_;
+    std::vector<double> k_arr_, cp_arr_, rho_arr_;
+    std::vector<double> Qvol_;
+
     // Time parameters
     double t_end_;
     int nt_;
 
+    // Heat source model and the path it follows: the one source of the
+    // configuration, or one per config_.sources entry
+    struct Torch {
+        std::unique_ptr<HeatSource> source;
+        TorchPath path;
+        double delay = 0.0;
+    };
+    std::vector<Torch> torches_;
+
+    // Cells written into Qvol_ on the last step, cleared on the next
+    std::vector<CellWindow> source_windows_;
+
     // Derived parameters
     double Q_total_;    // Total heat input
     double T_melt_;     // Average melting temperature
     double T_crit_;     // Average critical temperature
 
     // Monitoring
-    std::vector<std::pair<int, int>> monitor_pts_;
-    std::vector<std::vector<double>> T_history_;
-    std::vector<double> time_history_;
+    ProbeSet probes_;
+    std::vector<double> monitor_values_;  // Scratch row for the current step
+    ThermalHistory history_;
+
+    // Time loop state shared by run() and begin()/advance()
+    bool started_ = false;
+    bool finished_ = false;
+    int step_ = 0;                // Last completed step
+    double t_ = 0.0;              // Simulation time after step_
+    bool snapshot_taken_ = false;
+    int frame_counter_ = 0;
+    int frame_interval_ = 1;      // Save every N steps for video
+    std::unique_ptr<TelemetryPublisher> telemetry_;
+
+    // Checkpointing
+    int start_step_ = 0;          // Last completed step (non-zero after restart)
+    double start_time_ = 0.0;     // Simulation time at start_step_
+    CheckpointWriter checkpoint_writer_;
 
     // Helper functions
-    void initializeGrid();
     void initializeMaterials();
     void setupMonitoringPoints();
 
     // Index conversion: (i, j) -> linear index
     inline int idx(int i, int j) const { return j * nx_ + i; }
 
-    // Compute Goldak heat flux
-    void computeGoldakHeatFlux(double x_arc, std::vector<double>& q_surf) const;
-
     // Compute material properties for all grid points
     void computeMaterialProperties(const std::vector<double>& T_vec,
                                   std::vector<double>& k_arr,
                                   std::vector<double>& cp_arr,
                                   std::vector<double>& rho_arr) const;
 
-    // Solve one time step
+    // Solve one time step ending at time t
     void solveTimeStep(double t, const std::vector<double>& Qvol);
 
+    // Explicit update of T_ into T_new_ with the current property arrays
+    void applyStencil(const std::vector<double>& Qvol);
+
+    // Update T_max and the cooling accumulators from the step ending at t
+    void updateAccumulators(double t, const std::vector<double>& T_old);
+
     // Apply boundary conditions (Dirichlet)
     inline bool isBoundary(int i, int j) const {
         return (i == 0 || i == nx_ - 1 || j == 0 || j == ny_ - 1);
     }
 
-    // Update monitoring points
-    void updateMonitoring(double t);
+    // Sample the probes due at this step into the history
+    void updateMonitoring(int step, double t);
+
+    // Hand a copy of the current state to the background checkpoint writer
+    void writeCheckpoint(int step, double t);
+
+    // Copy of the complete solver state after `step` (time t)
+    CheckpointState captureState(int step, double t) const;
 
-    // Compute zones
-    void computeZones(std::vector<bool>& fusion_zone,
-                     std::vector<bool>& HAZ_zone) const;
+    // Validate state against this run and adopt it; `source` names it in errors
+    void restoreState(CheckpointState state, const std::string& source);
+
+    // Adopt the final state of an identical cached run; false on a miss
+    bool loadCachedResult();
+
+    // Add the finished run (ending at time t) to the cache; failures only warn
+    void storeCachedResult(double t) const;
+
+    // Cells `source` can heat noticeably when centred at (x_src, y_src),
+    // clipped to the grid
+    CellWindow sourceWindow(const HeatSource& source, double x_src, double y_src) const;
+
+    // Fill Qvol_ with the heat input of every torch on its path at time t;
+    // returns the bounding box of their windows (empty when all are off)
+    CellWindow computeSourceTerm(double t);
+
+    // Create the publisher if config_.telemetry_path is set
+    void startTelemetry();
+
+    // Telemetry record of the state after `step` (time t)
+    TelemetryRecord telemetryRecord(int step, double t) const;
 
     // Print statistics
     void printStatistics() const;
+
+    // Output file path inside config_.output_dir
+    std::string outputPath(const std::string& name) const;
 };
 
 #endif // WELDING_SIMULATION_H
@@ -0,0 +1,197 @@
+#include "ZoneTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const int SAMPLE_FIELDS = 8;  // Doubles per MeltPoolSample in checkpoints
+
+} // namespace
+
+void PackedBitset::resize(size_t n) {
+    size_ = n;
+    words_.assign((n + 63) / 64, 0);
+}
+
+size_t PackedBitset::count() const {
+    size_t total = 0;
+    for (std::uint64_t w : words_) {
+        total += __builtin_popcountll(w);
+    }
+    return total;
+}
+
+void ZoneTracker::reset(const std::vector<double>& x, const std::vector<double>& y,
+                        double T_melt, double T_crit, int capacity) {
+    x_ = x;
+    y_ = y;
+    nx_ = static_cast<int>(x.size());
+    ny_ = static_cast<int>(y.size());
+    dx_ = x[1] - x[0];
+    dy_ = y[1] - y[0];
+    T_melt_ = T_melt;
+    T_crit_ = T_crit;
+
+    fusion_.resize(static_cast<size_t>(nx_) * ny_);
+    crit_.resize(static_cast<size_t>(nx_) * ny_);
+    fusion_count_ = 0;
+    crit_count_ = 0;
+    hot_box_ = CellWindow();
+
+    samples_.clear();
+    samples_.reserve(capacity);
+}
+
+const MeltPoolSample& ZoneTracker::update(double t, const double* T, const CellWindow& source_window) {
+    // Window = previous hot box grown by one cell, joined with the source footprint
+    CellWindow w;
+    if (!hot_box_.empty()) {
+        w = {hot_box_.i0 - 1, hot_box_.i1 + 1, hot_box_.j0 - 1, hot_box_.j1 + 1};
+    }
+    if (!source_window.empty()) {
+        if (w.empty()) {
+            w = source_window;
+        } else {
+            w.i0 = std::min(w.i0, source_window.i0);
+            w.i1 = std::max(w.i1, source_window.i1);
+            w.j0 = std::min(w.j0, source_window.j0);
+            w.j1 = std::max(w.j1, source_window.j1);
+        }
+    }
+    w.i0 = std::max(w.i0, 0);
+    w.i1 = std::min(w.i1, nx_ - 1);
+    w.j0 = std::max(w.j0, 0);
+    w.j1 = std::min(w.j1, ny_ - 1);
+
+    CellWindow hot;
+    hot.i0 = nx_; hot.i1 = -1; hot.j0 = ny_; hot.j1 = -1;
+    int pool_i0 = nx_, pool_i1 = -1, pool_j0 = ny_, pool_j1 = -1;
+    size_t pool_cells = 0;
+    double sum_x = 0.0, sum_y = 0.0;
+    double T_peak = -std::numeric_limits<double>::infinity();
+
+    // The window is small, so a serial scan beats an OpenMP fork/join here
+    for (int j = w.j0; j <= w.j1; ++j) {
+        for (int i = w.i0; i <= w.i1; ++i) {
+            const size_t index = static_cast<size_t>(j) * nx_ + i;
+            const double T_cell = T[index];
+            T_peak = std::max(T_peak, T_cell);
+
+            if (T_cell < T_crit_) {
+                continue;
+            }
+
+            hot.i0 = std::min(hot.i0, i); hot.i1 = std::max(hot.i1, i);
+            hot.j0 = std::min(hot.j0, j); hot.j1 = std::max(hot.j1, j);
+            if (!crit_.test(index)) {
+                crit_.set(index);
+                ++crit_count_;
+            }
+
+            if (T_cell >= T_melt_) {
+                if (!fusion_.test(index)) {
+                    fusion_.set(index);
+                    ++fusion_count_;
+                }
+                pool_i0 = std::min(pool_i0, i); pool_i1 = std::max(pool_i1, i);
+                pool_j0 = std::min(pool_j0, j); pool_j1 = std::max(pool_j1, j);
+                sum_x += x_[i];
+                sum_y += y_[j];
+                ++pool_cells;
+            }
+        }
+    }
+    hot_box_ = hot;
+
+    MeltPoolSample sample;
+    sample.time = t;
+    sample.T_peak = T_peak;
+    if (pool_cells > 0) {
+        sample.length = (pool_i1 - pool_i0 + 1) * dx_;
+        sample.width = (pool_j1 - pool_j0 + 1) * dy_;
+        sample.area = pool_cells * dx_ * dy_;
+        sample.centroid_x = sum_x / pool_cells;
+        sample.centroid_y = sum_y / pool_cells;
+        sample.trailing_x = x_[pool_i0];
+    } else {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        sample.length = sample.width = sample.area = 0.0;
+        sample.centroid_x = sample.centroid_y = sample.trailing_x = nan;
+    }
+
+    samples_.push_back(sample);
+    return samples_.back();
+}
+
+void ZoneTracker::saveState(std::vector<std::uint64_t>& fusion_words,
+                            std::vector<std::uint64_t>& crit_words,
+                            std::vector<int>& hot_box, std::vector<double>& samples) const {
+    fusion_words = fusion_.words();
+    crit_words = crit_.words();
+    hot_box = {hot_box_.i0, hot_box_.i1, hot_box_.j0, hot_box_.j1};
+
+    samples.clear();
+    samples.reserve(samples_.size() * SAMPLE_FIELDS);
+    for (const auto& s : samples_) {
+        samples.insert(samples.end(), {s.time, s.T_peak, s.length, s.width, s.area,
+                                       s.centroid_x, s.centroid_y, s.trailing_x});
+    }
+}
+
+void ZoneTracker::restoreState(const std::vector<std::uint64_t>& fusion_words,
+                               const std::vector<std::uint64_t>& crit_words,
+                               const std::vector<int>& hot_box, const std::vector<double>& samples) {
+    if (fusion_words.size() != fusion_.words().size() ||
+        crit_words.size() != crit_.words().size() ||
+        hot_box.size() != 4 || samples.size() % SAMPLE_FIELDS != 0 ||
+        samples.size() / SAMPLE_FIELDS > samples_.capacity()) {
+        throw std::runtime_error("Zone tracker state does not match the grid");
+    }
+
+    fusion_.words() = fusion_words;
+    crit_.words() = crit_words;
+    fusion_count_ = fusion_.count();
+    crit_count_ = crit_.count();
+    hot_box_ = {hot_box[0], hot_box[1], hot_box[2], hot_box[3]};
+
+    samples_.clear();
+    for (size_t k = 0; k < samples.size(); k += SAMPLE_FIELDS) {
+        const double* v = &samples[k];
+        samples_.push_back({v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]});
+    }
+}
+
+void ZoneTracker::writeMeltPoolCsv(std::ostream& out) const {
+    out << std::setprecision(6) << std::fixed;
+    out << "time,T_peak,pool_length,pool_width,pool_area,centroid_x,centroid_y,trailing_x\n";
+
+    for (const auto& s : samples_) {
+        out << s.time << "," << s.T_peak << "," << s.length << "," << s.width << ","
+            << std::setprecision(9) << s.area << std::setprecision(6);
+        // No melt pool: centroid and trailing edge are left empty
+        if (s.area > 0.0) {
+            out << "," << s.centroid_x << "," << s.centroid_y << "," << s.trailing_x;
+        } else {
+            out << ",,,";
+        }
+        out << "\n";
+    }
+}
+
+void ZoneTracker::writeZoneMap(std::ostream& out) const {
+    PackedBitset haz = crit_;
+    for (size_t w = 0; w < haz.words().size(); ++w) {
+        haz.words()[w] &= ~fusion_.words()[w];
+    }
+
+    const std::int32_t dims[2] = {nx_, ny_};
+    out.write("WELDZONE", 8);
+    out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    out.write(reinterpret_cast<const char*>(fusion_.words().data()),
+              fusion_.words().size() * sizeof(std::uint64_t));
+    out.write(reinterpret_cast<const char*>(haz.words().data()),
+              haz.words().size() * sizeof(std::uint64_t));
+}
@@ -0,0 +1,101 @@
+#ifndef ZONE_TRACKER_H
+#define ZONE_TRACKER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <ostream>
+
+// One bit per grid cell, packed into 64-bit words
+class PackedBitset {
+public:
+    void resize(size_t n);
+    size_t size() const { return size_; }
+
+    bool test(size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1u; }
+    void set(size_t i) { words_[i >> 6] |= std::uint64_t(1) << (i & 63); }
+    size_t count() const;
+
+    std::vector<std::uint64_t>& words() { return words_; }
+    const std::vector<std::uint64_t>& words() const { return words_; }
+
+private:
+    std::vector<std::uint64_t> words_;
+    size_t size_ = 0;
+};
+
+// Inclusive range of cells [i0, i1] x [j0, j1]; empty when i0 > i1
+struct CellWindow {
+    int i0 = 0, i1 = -1;
+    int j0 = 0, j1 = -1;
+
+    bool empty() const { return i0 > i1 || j0 > j1; }
+};
+
+// Melt pool geometry for one time step (lengths in m, area in m²).
+// Centroid and trailing edge are NaN when there is no liquid cell.
+struct MeltPoolSample {
+    double time;
+    double T_peak;       // Hottest cell in the scanned window (K)
+    double length;       // Extent in x
+    double width;        // Extent in y
+    double area;
+    double centroid_x;
+    double centroid_y;
+    double trailing_x;   // Rearmost liquid x position
+};
+
+// Tracks the fusion zone (T >= T_melt at some step) and the region that
+// reached T_crit, plus per-step melt pool metrics.
+//
+// Only a window is scanned each step: the box of cells that were at or above
+// T_crit on the previous step grown by one cell, joined with the heat source
+// footprint. Away from the source the explicit update is a convex
+// combination of a cell and its neighbours, so a cell can only reach T_crit
+// next to one that already has; the window therefore sees every new zone
+// cell while touching a small fraction of the grid.
+class ZoneTracker {
+public:
+    void reset(const std::vector<double>& x, const std::vector<double>& y,
+               double T_melt, double T_crit, int capacity);
+
+    // Scan T (row-major, x fastest) and record one melt pool sample
+    const MeltPoolSample& update(double t, const double* T, const CellWindow& source_window);
+
+    const PackedBitset& fusionZone() const { return fusion_; }
+    const PackedBitset& critZone() const { return crit_; }
+    size_t fusionCount() const { return fusion_count_; }
+    size_t HAZCount() const { return crit_count_ - fusion_count_; }
+
+    const std::vector<MeltPoolSample>& samples() const { return samples_; }
+
+    // Checkpoint support: flat copies of the tracker state
+    void saveState(std::vector<std::uint64_t>& fusion_words, std::vector<std::uint64_t>& crit_words,
+                   std::vector<int>& hot_box, std::vector<double>& samples) const;
+    void restoreState(const std::vector<std::uint64_t>& fusion_words,
+                      const std::vector<std::uint64_t>& crit_words,
+                      const std::vector<int>& hot_box, const std::vector<double>& samples);
+
+    // Melt pool time series as CSV
+    void writeMeltPoolCsv(std::ostream& out) const;
+
+    // Binary zone map: "WELDZONE", nx, ny (int32), then the fusion and HAZ
+    // bitsets as little-endian 64-bit words (bit i = cell j * nx + i)
+    void writeZoneMap(std::ostream& out) const;
+
+private:
+    std::vector<double> x_, y_;
+    int nx_ = 0, ny_ = 0;
+    double dx_ = 0.0, dy_ = 0.0;
+    double T_melt_ = 0.0, T_crit_ = 0.0;
+
+    PackedBitset fusion_;
+    PackedBitset crit_;
+    size_t fusion_count_ = 0;
+    size_t crit_count_ = 0;
+
+    CellWindow hot_box_;  // Cells at or above T_crit on the last step
+    std::vector<MeltPoolSample> samples_;
+};
+
+#endif // ZONE_TRACKER_H
@@ -1,61 +1,147 @@
 #include "WeldingSimulation.h"
+#include "CommandLine.h"
+#include "BatchRunner.h"
+#include "ConfigLoader.h"
+#include "Sweep.h"
+#include "Calibration.h"
+#include "ReducedOrderModel.h"
+#include "Rosenthal.h"
+#include "Profiler.h"
+#include "SimulationServer.h"
 #include <iostream>
-#include <cstring>
-#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
 #include <omp.h>
 
 void printUsage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [options]" << std::endl;
+    std::cout << "\nConfiguration File:" << std::endl;
+    std::cout << "  --config <file.json>            Load parameters from a JSON file (config.json schema);" << std::endl;
+    std::cout << "                                  options after it override its values" << std::endl;
+    std::cout << "  --save_config <file.json>       Write the effective configuration and exit" << std::endl;
     std::cout << "\nProcess Options:" << std::endl;
-    std::cout << "  --weld_process <TIG|Electrode>  Welding process (default: TIG)" << std::endl;
+    std::cout << "  --weld_process <TIG|Electrode|Custom|EBW|LBW|PAW|SAW|ERW>" << std::endl;
+    std::cout << "                                  Welding process (default: TIG; all but TIG and Electrode" << std::endl;
+    std::cout << "                                  use --eta)" << std::endl;
     std::cout << "  --use_gas                       Enable shielding gas (default: enabled)" << std::endl;
     std::cout << "  --no-gas                        Disable shielding gas" << std::endl;
+    std::cout << "  --weld_direction <x|y>          Travel along x, or along the interface in y (default: x)" << std::endl;
     std::cout << "\nPhysical Parameters:" << std::endl;
     std::cout << "  --current <A>                   Welding current in Amperes (default: 150)" << std::endl;
     std::cout << "  --voltage <V>                   Arc voltage in Volts (default: 25)" << std::endl;
     std::cout << "  --speed <m/s>                   Welding speed in m/s (default: 0.006)" << std::endl;
+    std::cout << "  --eta <0-1>                     Process efficiency unless TIG/Electrode (default: 0.85)" << std::endl;
+    std::cout << "  --x_start <m>                   Arc start position in x (default: 0.02)" << std::endl;
+    std::cout << "  --y_arc <m>                     Arc position in y (default: 0.0)" << std::endl;
+    std::cout << "  --a, --b <m>                    Goldak semi-axes in x and y (default: 0.005, 0.004)" << std::endl;
+    std::cout << "  --cf, --cr <m>                  Goldak front/rear depths (default: 0.003, 0.010)" << std::endl;
+    std::cout << "  --ff, --fr                      Goldak front/rear fractions (default: 0.6, 1.4)" << std::endl;
+    std::cout << "  --Q_beam <W>                    Beam power for EBW and LBW (default: 3000)" << std::endl;
+    std::cout << "  --R_beam <m>                    Beam / plasma radius for EBW, LBW, PAW (default: 0.001)" << std::endl;
+    std::cout << "  --H_beam <m>                    Penetration depth for EBW and PAW (default: 0.006)" << std::endl;
+    std::cout << "  --erw_current_density <A/m2>    ERW peak current density (default: 8e6)" << std::endl;
+    std::cout << "  --erw_sigma_e <S/m>             ERW electrical conductivity (default: 4.5e6)" << std::endl;
+    std::cout << "  --erw_contact_width <m>         ERW contact zone width (default: 0.005)" << std::endl;
+    std::cout << "  --erw_contact_resistance <Ohm m2>" << std::endl;
+    std::cout << "                                  ERW cold contact resistance (default: 1e-6)" << std::endl;
+    std::cout << "  --erw_melt_factor <0-1>         ERW contact resistance fraction at T_melt (default: 0.1)" << std::endl;
+    std::cout << "\nDomain and Mesh:" << std::endl;
+    std::cout << "  --Lx, --Ly <m>                  Plate size (default: 0.15 x 0.10)" << std::endl;
+    std::cout << "  --thickness <m>                 Plate thickness (default: 0.006)" << std::endl;
+    std::cout << "  --nx, --ny <n>                  Grid points (default: 151 x 101)" << std::endl;
+    std::cout << "  --dt <s>                        Time step (default: 0.02)" << std::endl;
+    std::cout << "  --t_end <s>                     Simulated time (default: until the arc leaves + 10 s)" << std::endl;
+    std::cout << "  --T0 <K>                        Ambient temperature (default: 293.0)" << std::endl;
+    std::cout << "  --constant_properties           Room-temperature k, cp, rho at every temperature" << std::endl;
     std::cout << "\nMaterial 1 Properties (Mild Steel):" << std::endl;
     std::cout << "  --mat1_k <W/mK>                 Thermal conductivity (default: 45.0)" << std::endl;
     std::cout << "  --mat1_cp <J/kgK>               Specific heat (default: 500.0)" << std::endl;
     std::cout << "  --mat1_rho <kg/m3>              Density (default: 7850.0)" << std::endl;
     std::cout << "  --mat1_Tmelt <K>                Melting temperature (default: 1811.0)" << std::endl;
+    std::cout << "  --mat1_Tcrit <K>                Critical (HAZ) temperature (default: 1273.0)" << std::endl;
     std::cout << "\nMaterial 2 Properties (Stainless Steel 304):" << std::endl;
     std::cout << "  --mat2_k <W/mK>                 Thermal conductivity (default: 16.3)" << std::endl;
     std::cout << "  --mat2_cp <J/kgK>               Specific heat (default: 500.0)" << std::endl;
     std::cout << "  --mat2_rho <kg/m3>              Density (default: 7900.0)" << std::endl;
     std::cout << "  --mat2_Tmelt <K>                Melting temperature (default: 1723.0)" << std::endl;
+    std::cout << "  --mat2_Tcrit <K>                Critical (HAZ) temperature (default: 1273.0)" << std::endl;
     std::cout << "\nVideo Options:" << std::endl;
     std::cout << "  --save_video                    Enable video frame saving" << std::endl;
     std::cout << "  --video_fps <fps>               Video frames per second (default: 10)" << std::endl;
+    std::cout << "\nCheckpoint Options:" << std::endl;
+    std::cout << "  --checkpoint_interval <steps>   Write a checkpoint every N steps (default: 0, disabled)" << std::endl;
+    std::cout << "  --checkpoint_file <path>        Checkpoint file (default: <output_dir>/checkpoint.bin)" << std::endl;
+    std::cout << "  --restart <path>                Resume from a checkpoint file" << std::endl;
+    std::cout << "\nOutput Options:" << std::endl;
+    std::cout << "  --output_dir <dir>              Directory for result files (default: output)" << std::endl;
+    std::cout << "  --probes <file.csv>             Monitoring probes, one 'name,x,y[,interval]' per line" << std::endl;
+    std::cout << "  --path <file.json>              Torch path: line/arc segments, speed and power ramps, weave" << std::endl;
+    std::cout << "  --sources <file.json>           Simultaneous heat sources, each with its own parameters and path" << std::endl;
+    std::cout << "  --history_chunk <rows>          Stream thermal history to disk every N rows (default: 0, in memory)" << std::endl;
+    std::cout << "  --telemetry <path>              Publish live JSON lines to a Unix domain socket or FIFO" << std::endl;
+    std::cout << "  --telemetry_hz <hz>             Telemetry records per second (default: 2)" << std::endl;
+    std::cout << "\nResult Cache:" << std::endl;
+    std::cout << "  --cache                         Reuse the result of an identical earlier run, and store this one" << std::endl;
+    std::cout << "  --no-cache                      Always simulate; do not read or write the cache (default)" << std::endl;
+    std::cout << "  --cache_dir <dir>               Cache directory (default: .weld_cache)" << std::endl;
+    std::cout << "  --cache_max_mb <MB>             Size limit, least recently used entries evicted (default: 512)" << std::endl;
+    std::cout << "\nBatch Options:" << std::endl;
+    std::cout << "  --batch <file>                  Run every '<name> [options...]' line of <file> in this process;" << std::endl;
+    std::cout << "                                  other options are defaults, results go to <output_dir>/<name>" << std::endl;
+    std::cout << "  --jobs <n>                      Scenarios run concurrently in batch mode (default: 1)" << std::endl;
+    std::cout << "  --ensemble                      Advance compatible batch scenarios together in one vectorized sweep" << std::endl;
+    std::cout << "                                  (writes simulation_results.csv only)" << std::endl;
+    std::cout << "\nSweep Options:" << std::endl;
+    std::cout << "  --sweep <file.json>             Run a grid or Latin hypercube parameter study on --jobs threads;" << std::endl;
+    std::cout << "                                  writes <output_dir>/sweep_summary.csv" << std::endl;
+    std::cout << "\nCalibration Options:" << std::endl;
+    std::cout << "  --calibrate <file.json>         Fit parameters to measured thermocouple curves (candidates on --jobs threads);" << std::endl;
+    std::cout << "                                  writes calibration_log.csv and calibrated_config.json to <output_dir>" << std::endl;
+    std::cout << "\nReduced-Order Model Options:" << std::endl;
+    std::cout << "  --rom_train <file.json>         Run a sweep file and build a surrogate of the T_max map;" << std::endl;
+    std::cout << "                                  writes rom.bin and rom_validation.csv to <output_dir>" << std::endl;
+    std::cout << "  --rom_holdout <n>               Training runs held out to estimate the error (default: 20%)" << std::endl;
+    std::cout << "  --rom <rom.bin>                 Predict T_max, fusion and HAZ areas for the given options" << std::endl;
+    std::cout << "\nAnalytic Solution:" << std::endl;
+    std::cout << "  --analytic                      Evaluate the Rosenthal thin-plate solution instead of simulating;" << std::endl;
+    std::cout << "                                  writes <output_dir>/analytic_results.csv" << std::endl;
+    std::cout << "\nProfiling (builds with WELD_ENABLE_PROFILING):" << std::endl;
+    std::cout << "  --profile <report.json>         Time each phase of the run (count, total, min/max/p99)" << std::endl;
+    std::cout << "  --profile_trace <trace.json>    Also write every timed scope as a Chrome trace-event file" << std::endl;
+    std::cout << "  --perf_counters                 Count cycles, instructions and LLC misses per phase and thread" << std::endl;
+    std::cout << "                                  (Linux perf_event_open) and print a roofline summary" << std::endl;
+    std::cout << "\nServer Options:" << std::endl;
+    std::cout << "  --serve <socket>                Run jobs sent to a Unix domain socket until shut down;" << std::endl;
+    std::cout << "                                  --jobs run at once, other options are job defaults" << std::endl;
+    std::cout << "  --large_cells <n>               Jobs with at least n cells run alone with all threads (default: 200000)" << std::endl;
+    std::cout << "  --submit <socket>               Send the configuration options as a job to a server and print the reply" << std::endl;
+    std::cout << "  --job_name <name>               Job name, results in <server output_dir>/<name> (default: job<n>)" << std::endl;
+    std::cout << "  --server_command <cmd>          With --submit: send 'status' or 'shutdown' instead of a job" << std::endl;
     std::cout << "\nOther Options:" << std::endl;
     std::cout << "  --snapshot_time <seconds>       Time for snapshot (default: -1, disabled)" << std::endl;
     std::cout << "  --help                          Show this help message" << std::endl;
 }
 
-void createOutputDirectory() {
-    struct stat info;
-    if (stat("output", &info) != 0) {
-        // Directory doesn't exist, create it
-        #ifdef _WIN32
-            mkdir("output");
-        #else
-            mkdir("output", 0755);
-        #endif
-        std::cout << "Created output directory." << std::endl;
-    }
-}
-
-void createVideoFramesDirectory() {
-    struct stat info;
-    if (stat("output/video_frames", &info) != 0) {
-        // Directory doesn't exist, create it
-        #ifdef _WIN32
-            mkdir("output/video_frames");
-        #else
-            mkdir("output/video_frames", 0755);
-        #endif
-        std::cout << "Created output/video_frames directory." << std::endl;
+// Per-phase table of the profiled run
+void printProfile(const Profiler& profiler) {
+    const double wall = profiler.elapsed();
+    std::cout << "\n=== Phase Timing ===" << std::endl;
+    std::cout << std::left << std::setw(14) << "phase" << std::right << std::setw(10) << "count"
+              << std::setw(12) << "total (s)" << std::setw(8) << "%" << std::setw(12) << "mean (us)"
+              << std::setw(12) << "p99 (us)" << std::setw(12) << "max (us)" << std::endl;
+    for (const PhaseSummary& s : profiler.summary()) {
+        std::cout << std::left << std::setw(14) << profilePhaseName(s.phase) << std::right
+                  << std::setw(10) << s.count << std::setw(12) << std::setprecision(4) << s.total
+                  << std::setw(8) << std::setprecision(3) << (wall > 0.0 ? 100.0 * s.total / wall : 0.0)
+                  << std::setw(12) << std::setprecision(4) << s.total / s.count * 1e6
+                  << std::setw(12) << s.p99 * 1e6 << std::setw(12) << s.max * 1e6 << std::endl;
     }
+    std::cout << std::setprecision(6) << "Profiled wall time: " << wall << " s" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -65,78 +151,393 @@ int main(int argc, char* argv[]) {
     // Default configuration
     SimulationConfig config;
 
+    std::string batch_file;
+    int batch_jobs = 1;
+    bool ensemble = false;
+    std::string save_config_file;
+    std::string sweep_file;
+    std::string calibration_file;
+    std::string rom_train_file;
+    std::string rom_file;
+    int rom_holdout = -1;
+    bool analytic = false;
+    std::string profile_file;
+    std::string profile_trace_file;
+    bool perf_counters = false;
+    ServerOptions server;
+    std::string submit_socket;
+    std::string job_name;
+    std::string server_command;
+    std::vector<std::string> job_options;   // Configuration options, forwarded by --submit
+
     // Parse command line arguments
-    for (int i = 1; i < argc; ++i) {
-        if (strcmp(argv[i], "--help") == 0) {
-            printUsage(argv[0]);
-            return 0;
-        } else if (strcmp(argv[i], "--weld_process") == 0 && i + 1 < argc) {
-            config.weld_process = argv[++i];
-            if (config.weld_process != "TIG" && config.weld_process != "Electrode") {
-                std::cerr << "Error: Invalid weld_process. Use 'TIG' or 'Electrode'." << std::endl;
-                return 1;
-            }
-        } else if (strcmp(argv[i], "--use_gas") == 0) {
-            config.use_gas = true;
-        } else if (strcmp(argv[i], "--no-gas") == 0) {
-            config.use_gas = false;
-        } else if (strcmp(argv[i], "--snapshot_time") == 0 && i + 1 < argc) {
-            config.snapshot_time = std::stod(argv[++i]);
+    std::vector<std::string> args(argv + 1, argv + argc);
+    for (size_t i = 0; i < args.size(); ++i) {
+        try {
+            if (args[i] == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (args[i] == "--batch" && i + 1 < args.size()) {
+                batch_file = args[++i];
+            } else if (args[i] == "--jobs" && i + 1 < args.size()) {
+                batch_jobs = std::stoi(args[++i]);
+            } else if (args[i] == "--ensemble") {
+                ensemble = true;
+            } else if (args[i] == "--sweep" && i + 1 < args.size()) {
+                sweep_file = args[++i];
+            } else if (args[i] == "--calibrate" && i + 1 < args.size()) {
+                calibration_file = args[++i];
+            } else if (args[i] == "--rom_train" && i + 1 < args.size()) {
+                rom_train_file = args[++i];
+            } else if (args[i] == "--rom_holdout" && i + 1 < args.size()) {
+                rom_holdout = std::stoi(args[++i]);
+            } else if (args[i] == "--rom" && i + 1 < args.size()) {
+                rom_file = args[++i];
+            } else if (args[i] == "--analytic") {
+                analytic = true;
+            } else if (args[i] == "--profile" && i + 1 < args.size()) {
+                profile_file = args[++i];
+            } else if (args[i] == "--profile_trace" && i + 1 < args.size()) {
+                profile_trace_file = args[++i];
+            } else if (args[i] == "--perf_counters") {
+                perf_counters = true;
+            } else if (args[i] == "--save_config" && i + 1 < args.size()) {
+                save_config_file = args[++i];
+            } else if (args[i] == "--serve" && i + 1 < args.size()) {
+                server.socket_path = args[++i];
+            } else if (args[i] == "--large_cells" && i + 1 < args.size()) {
+                server.large_cells = std::stol(args[++i]);
+            } else if (args[i] == "--submit" && i + 1 < args.size()) {
+                submit_socket = args[++i];
+            } else if (args[i] == "--job_name" && i + 1 < args.size()) {
+                job_name = args[++i];
+            } else if (args[i] == "--server_command" && i + 1 < args.size()) {
+                server_command = args[++i];
+            } else {
+                const size_t first = i;
+                if (!applyConfigOption(args, i, config)) {
+                    std::cerr << "Error: Unknown option '" << args[i] << "'" << std::endl;
+                    printUsage(argv[0]);
+                    return 1;
+                }
+                job_options.insert(job_options.end(), args.begin() + first, args.begin() + i + 1);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
         }
-        // Physical parameters
-        else if (strcmp(argv[i], "--current") == 0 && i + 1 < argc) {
-            config.I = std::stod(argv[++i]);
-        } else if (strcmp(argv[i], "--voltage") == 0 && i + 1 < argc) {
-            config.V = std::stod(argv[++i]);
-        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
-            config.v_weld = std::stod(argv[++i]);
+    }
+
+    if (!save_config_file.empty()) {
+        try {
+            saveConfigFile(save_config_file, config);
+            std::cout << "Configuration written to " << save_config_file << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
         }
-        // Material 1 properties
-        else if (strcmp(argv[i], "--mat1_k") == 0 && i + 1 < argc) {
-            config.mat_1_k = std::stod(argv[++i]);
-        } else if (strcmp(argv[i], "--mat1_cp") == 0 && i + 1 < argc) {
-            config.mat_1_cp = std::stod(argv[++i]);
-        } else if (strcmp(argv[i], "--mat1_rho") == 0 && i + 1 < argc) {
-            config.mat_1_rho = std::stod(argv[++i]);
-        } else if (strcmp(argv[i], "--mat1_Tmelt") == 0 && i + 1 < argc) {
-            config.mat_1_T_melt = std::stod(argv[++i]);
+        return 0;
+    }
+
+    if (ensemble && batch_file.empty()) {
+        std::cerr << "Error: --ensemble requires --batch" << std::endl;
+        return 1;
+    }
+
+    const bool profile = !profile_file.empty() || !profile_trace_file.empty() || perf_counters;
+    if (profile && !PROFILING_COMPILED) {
+        std::cerr << "Error: --profile and --perf_counters need a build with WELD_ENABLE_PROFILING "
+                  << "(cmake -DWELD_ENABLE_PROFILING=ON or make PROFILE=1)" << std::endl;
+        return 1;
+    }
+
+    // Client mode: hand the job (or a command) to a running server
+    if (!submit_socket.empty()) {
+        try {
+            JsonValue request = JsonValue::makeObject();
+            if (!server_command.empty()) {
+                request.set("command", JsonValue::makeString(server_command));
+            } else {
+                if (!job_name.empty()) {
+                    request.set("name", JsonValue::makeString(job_name));
+                }
+                JsonValue options = JsonValue::makeArray();
+                for (const auto& option : job_options) {
+                    options.array.push_back(JsonValue::makeString(option));
+                }
+                request.set("options", options);
+            }
+
+            JsonValue reply = sendServerRequest(submit_socket, request);
+            writeJson(std::cout, reply);
+            std::cout << std::endl;
+            const JsonValue* ok = reply.find("ok");
+            return (ok && ok->isBool() && ok->boolean) ? 0 : 1;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
         }
-        // Material 2 properties
-        else if (strcmp(argv[i], "--mat2_k") == 0 && i + 1 < argc) {
-            config.mat_2_k = std::stod(argv[++i]);
-        } else if (strcmp(argv[i], "--mat2_cp") == 0 && i + 1 < argc) {
-            config.mat_2_cp = std::stod(argv[++i]);
-        } else if (strcmp(argv[i], "--mat2_rho") == 0 && i + 1 < argc) {
-            config.mat_2_rho = std::stod(argv[++i]);
-        } else if (strcmp(argv[i], "--mat2_Tmelt") == 0 && i + 1 < argc) {
-            config.mat_2_T_melt = std::stod(argv[++i]);
+    }
+
+    // Server mode: jobs from clients until shut down
+    if (!server.socket_path.empty()) {
+        try {
+            server.workers = batch_jobs;
+            SimulationServer simulation_server(server, config);
+            simulation_server.serve();
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
         }
-        // Video options
-        else if (strcmp(argv[i], "--save_video") == 0) {
-            config.save_video_frames = true;
-        } else if (strcmp(argv[i], "--video_fps") == 0 && i + 1 < argc) {
-            config.video_frames_per_second = std::stoi(argv[++i]);
-        } else {
-            std::cerr << "Error: Unknown option '" << argv[i] << "'" << std::endl;
-            printUsage(argv[0]);
+        return 0;
+    }
+
+    // Sweep mode: generated parameter study
+    if (!sweep_file.empty()) {
+        try {
+            SweepDesign design = readSweepFile(sweep_file, config);
+            std::vector<SweepResult> results = runSweep(design, batch_jobs);
+
+            std::filesystem::create_directories(design.base.output_dir);
+            const std::string summary = design.base.output_dir + "/sweep_summary.csv";
+            std::ofstream out(summary);
+            if (!out.is_open()) {
+                throw std::runtime_error("Could not open file " + summary);
+            }
+            writeSweepSummary(out, design, results);
+            std::cout << "Sweep summary written to " << summary << std::endl;
+
+            for (const auto& r : results) {
+                if (!r.ok) {
+                    return 1;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
             return 1;
         }
+        return 0;
     }
 
-    // Create output directories
-    createOutputDirectory();
-    if (config.save_video_frames) {
-        createVideoFramesDirectory();
+    // Reduced-order model training: sweep, POD basis, held-out validation
+    if (!rom_train_file.empty()) {
+        try {
+            SweepDesign design = readSweepFile(rom_train_file, config);
+            std::vector<RomValidation> validation;
+            ReducedOrderModel model = trainReducedOrderModel(design, rom_holdout, batch_jobs, validation);
+
+            std::filesystem::create_directories(design.base.output_dir);
+            const std::string model_file = design.base.output_dir + "/rom.bin";
+            model.save(model_file);
+
+            std::cout << "\n=== Reduced-Order Model ===" << std::endl;
+            std::cout << "Training runs: " << model.trainingRuns() << ", modes: " << model.rank()
+                      << " (" << model.capturedEnergy() * 100.0 << "% of snapshot energy)" << std::endl;
+
+            if (!validation.empty()) {
+                const std::string report = design.base.output_dir + "/rom_validation.csv";
+                std::ofstream out(report);
+                if (!out.is_open()) {
+                    throw std::runtime_error("Could not open file " + report);
+                }
+                writeRomValidation(out, model, validation);
+
+                double rms = 0.0, worst = 0.0, peak = 0.0, fusion = 0.0, haz = 0.0;
+                for (const auto& v : validation) {
+                    rms = std::max(rms, v.rms_error);
+                    worst = std::max(worst, v.max_error);
+                    peak = std::max(peak, std::fabs(v.rom.T_peak - v.full.T_peak));
+                    fusion = std::max(fusion, std::fabs(v.rom.fusion_area - v.full.fusion_area) * 1e6);
+                    haz = std::max(haz, std::fabs(v.rom.HAZ_area - v.full.HAZ_area) * 1e6);
+                }
+                std::cout << "Held-out runs: " << validation.size() << std::endl;
+                std::cout << "  Worst T_max map error: " << rms << " K RMS, " << worst << " K max" << std::endl;
+                std::cout << "  Worst peak temperature error: " << peak << " K" << std::endl;
+                std::cout << "  Worst area error: fusion " << fusion << " mm², HAZ " << haz << " mm²" << std::endl;
+                std::cout << "Validation written to " << report << std::endl;
+            }
+            std::cout << "Model written to " << model_file << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Reduced-order model evaluation at the configured parameter values
+    if (!rom_file.empty()) {
+        try {
+            ReducedOrderModel model;
+            model.load(rom_file);
+
+            std::vector<double> values;
+            for (const auto& name : model.parameterNames()) {
+                values.push_back(getConfigValue(config, name));
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            RomPrediction prediction = model.predict(values);
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+            std::cout << "\n=== Reduced-Order Prediction ===" << std::endl;
+            for (size_t k = 0; k < values.size(); ++k) {
+                std::cout << "  " << model.parameterNames()[k] << " = " << values[k] << std::endl;
+            }
+            if (!model.inTrainingRange(values)) {
+                std::cerr << "Warning: outside the training range; the prediction is extrapolated" << std::endl;
+            }
+            std::cout << "Peak Temperature: " << prediction.T_peak << " K" << std::endl;
+            std::cout << "Fusion Zone Area: " << prediction.fusion_area * 1e6 << " mm²" << std::endl;
+            std::cout << "HAZ Area: " << prediction.HAZ_area * 1e6 << " mm²" << std::endl;
+            std::cout << "Evaluated in " << ms << " ms" << std::endl;
+
+            SimulationConfig grid_config = config;
+            grid_config.nx = model.nx();
+            grid_config.ny = model.ny();
+            grid_config.Lx = model.Lx();
+            grid_config.Ly = model.Ly();
+            auto grid = makeGrid(grid_config);
+
+            std::filesystem::create_directories(config.output_dir);
+            const std::string map_file = config.output_dir + "/rom_T_max.csv";
+            std::ofstream out(map_file);
+            if (!out.is_open()) {
+                throw std::runtime_error("Could not open file " + map_file);
+            }
+            out << std::setprecision(6) << std::fixed;
+            out << "i,j,x,y,T_max" << std::endl;
+            for (int j = 0; j < grid->ny; ++j) {
+                for (int i = 0; i < grid->nx; ++i) {
+                    out << i << "," << j << "," << grid->x[i] << "," << grid->y[j] << ","
+                        << prediction.T_max[static_cast<size_t>(j) * grid->nx + i] << std::endl;
+                }
+            }
+            std::cout << "T_max map written to " << map_file << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Calibration mode: fit parameters to measured curves
+    if (!calibration_file.empty()) {
+        try {
+            CalibrationProblem problem = readCalibrationFile(calibration_file, config);
+
+            std::filesystem::create_directories(problem.base.output_dir);
+            const std::string log_file = problem.base.output_dir + "/calibration_log.csv";
+            std::ofstream log(log_file);
+            if (!log.is_open()) {
+                throw std::runtime_error("Could not open file " + log_file);
+            }
+
+            std::cout << "Calibrating " << problem.parameters.size() << " parameters against "
+                      << problem.measurements.size() << " measured curves" << std::endl;
+            CalibrationResult result = calibrate(problem, batch_jobs, log);
+
+            std::cout << "\n=== Calibration " << (result.converged ? "Converged" : "Stopped") << " ===" << std::endl;
+            for (size_t k = 0; k < problem.parameters.size(); ++k) {
+                std::cout << "  " << problem.parameters[k].name << " = " << result.values[k] << std::endl;
+            }
+            std::cout << "RMS misfit: " << result.initial_rms << " K -> " << result.rms << " K" << std::endl;
+            std::cout << "Forward solves: " << result.forward_solves
+                      << " (" << result.iterations << " iterations)" << std::endl;
+
+            const std::string fitted = problem.base.output_dir + "/calibrated_config.json";
+            saveConfigFile(fitted, result.config);
+            std::cout << "Evaluations written to " << log_file << std::endl;
+            std::cout << "Fitted configuration written to " << fitted << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Batch mode: many scenarios in this process
+    if (!batch_file.empty()) {
+        try {
+            std::vector<BatchScenario> scenarios = readBatchFile(batch_file, config);
+            std::vector<BatchResult> results = ensemble ? runEnsembleBatch(scenarios)
+                                                        : runBatch(scenarios, batch_jobs);
+            printBatchSummary(results, std::cout);
+
+            for (const auto& r : results) {
+                if (!r.ok) {
+                    return 1;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Analytic mode: closed-form Rosenthal estimate on the simulation grid
+    if (analytic) {
+        try {
+            auto grid = makeGrid(config);
+            auto start = std::chrono::steady_clock::now();
+            AnalyticResult result = runAnalytic(config, grid);
+            double us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+
+            std::cout << "\n=== Rosenthal Solution ===" << std::endl;
+            std::cout << "Evaluated in " << us << " us" << std::endl;
+            std::cout << "Peak Temperature: " << result.stats.T_peak << " K" << std::endl;
+            std::cout << "Fusion Zone Area: " << result.stats.fusion_area * 1e6 << " mm²" << std::endl;
+            std::cout << "HAZ Area: " << result.stats.HAZ_area * 1e6 << " mm²" << std::endl;
+            std::cout << "Centreline t8/5: " << result.stats.t85_min << " - "
+                      << result.stats.t85_max << " s" << std::endl;
+
+            std::filesystem::create_directories(config.output_dir);
+            const std::string filename = config.output_dir + "/analytic_results.csv";
+            writeAnalyticResults(filename, *grid, result);
+            std::cout << "Results written to " << filename << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
     }
 
     // Create and run simulation
     try {
+        // Create output directories
+        prepareOutputDirectories(config);
+
         WeldingSimulation sim(config);
+        if (perf_counters) {
+            std::string message;
+            if (!Profiler::instance().enableCounters(omp_get_max_threads(), message)) {
+                std::cerr << "Warning: no performance counters (" << message << "); timing phases only" << std::endl;
+            } else if (!message.empty()) {
+                std::cerr << "Warning: " << message << std::endl;
+            }
+        }
+        if (profile) {
+            Profiler::instance().start();
+        }
         sim.run();
+        if (profile) {
+            Profiler::instance().stop();
+            printProfile(Profiler::instance());
+            if (!profile_file.empty()) {
+                Profiler::instance().writeReport(profile_file);
+                std::cout << "Profile written to " << profile_file << std::endl;
+            }
+            if (!profile_trace_file.empty()) {
+                Profiler::instance().writeTrace(profile_trace_file);
+                std::cout << "Trace written to " << profile_trace_file << std::endl;
+            }
+        }
         sim.exportResults();
 
         std::cout << "\n=== Simulation Complete ===" << std::endl;
-        std::cout << "Results saved to output/ directory" << std::endl;
+        std::cout << "Results saved to " << config.output_dir << "/ directory" << std::endl;
         std::cout << "  - simulation_results.csv: Temperature field data" << std::endl;
         std::cout << "  - thermal_history.csv: Temperature history at monitoring points" << std::endl;
 
@@ -27,53 +27,49 @@ mkdir -p results
 
 # Array of scenarios (format: process:gas_status:args:gas_flag)
 declare -a scenarios=(
-    "TIG:with_gas:--weld_process TIG --use_gas --save_video:--use_gas"
-    "TIG:without_gas:--weld_process TIG --no-gas --save_video:--no-gas"
-    "Electrode:with_gas:--weld_process Electrode --use_gas --save_video:--use_gas"
-    "Electrode:without_gas:--weld_process Electrode --no-gas --save_video:--no-gas"
+    "TIG:with_gas:--weld_process TIG --use_gas:--use_gas"
+    "TIG:without_gas:--weld_process TIG --no-gas:--no-gas"
+    "Electrode:with_gas:--weld_process Electrode --use_gas:--use_gas"
+    "Electrode:without_gas:--weld_process Electrode --no-gas:--no-gas"
 )
 
-# Run each scenario
+# Write one batch line per scenario; welding_sim runs them all in one process
+# and writes each to results/<process>_<gas_status>/
+batch_file="results/scenarios.batch"
+: > "$batch_file"
 for scenario in "${scenarios[@]}"; do
     IFS=':' read -r process gas_status args gas_flag <<< "$scenario"
+    echo "${process}_${gas_status} $args" >> "$batch_file"
+done
 
-    echo "========================================================"
-    echo "Running Scenario: $process $gas_status"
-    echo "========================================================"
-    echo ""
+echo "========================================================"
+echo "Running all scenarios (batch file: $batch_file)"
+echo "========================================================"
+echo ""
 
-    # Create output directory for this scenario
-    output_dir="results/${process}_${gas_status}"
-    mkdir -p "$output_dir"
+# Two scenarios at a time keeps all cores busy on the default grid
+./welding_sim --batch "$batch_file" --jobs 2 --save_video --output_dir results
 
-    # Run simulation
-    echo "Command: ./welding_sim $args"
-    ./welding_sim $args | tee "${output_dir}/simulation_log.txt"
+# Generate videos from frames
+for scenario in "${scenarios[@]}"; do
+    IFS=':' read -r process gas_status args gas_flag <<< "$scenario"
+    output_dir="results/${process}_${gas_status}"
 
-    # Generate video from frames
-    if [ -d "output/video_frames" ] && [ "$(ls -A output/video_frames)" ]; then
+    if [ -d "${output_dir}/video_frames" ] && [ "$(ls -A ${output_dir}/video_frames)" ]; then
         echo ""
         echo "Generating video for $process $gas_status..."
         python3 generate_video.py \
-            --frames_dir output/video_frames \
+            --frames_dir "${output_dir}/video_frames" \
             --output "${output_dir}/welding_simulation.mp4" \
             --fps 10 \
             --weld_process "$process" \
             $gas_flag
         echo "Video saved to: ${output_dir}/welding_simulation.mp4"
     fi
-
-    # Move output files
-    if [ -d "output" ]; then
-        mv output/* "$output_dir/" 2>/dev/null || true
-        rmdir output 2>/dev/null || true
-    fi
-
-    echo ""
-    echo "Results saved to: $output_dir"
-    echo ""
 done
 
+echo ""
+
 echo "========================================================"
 echo "  All Scenarios Complete!"
 echo "========================================================"
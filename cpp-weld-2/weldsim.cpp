@@ -0,0 +1,387 @@
+#include "weldsim.h"
+#include "WeldingSimulation.h"
+#include "ConfigLoader.h"
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <filesystem>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+struct weldsim {
+    std::unique_ptr<WeldingSimulation> simulation;
+};
+
+namespace {
+
+thread_local std::string last_error;
+
+const char* const PROCESS_NAMES[] = {"TIG", "Electrode", "Custom", "EBW", "LBW", "PAW", "SAW", "ERW"};
+
+// Callers built against API version 1 pass the struct without the source fields
+const size_t CONFIG_V1_SIZE = offsetof(weldsim_config, Q_beam);
+
+void setError(const std::string& message) {
+    last_error = message;
+}
+
+void fillConfig(const SimulationConfig& s, weldsim_config& c);
+
+// Bytes of a caller's struct the library may touch: an older caller's struct
+// is shorter than ours, a newer one's longer
+size_t configBytes(const weldsim_config& c) {
+    return std::min<size_t>(c.struct_size, sizeof(weldsim_config));
+}
+
+// This library's defaults, the full struct
+weldsim_config defaultConfig() {
+    weldsim_config c = weldsim_config();
+    c.struct_size = sizeof(weldsim_config);
+    fillConfig(SimulationConfig(), c);
+    c.output_dir = nullptr;
+    return c;
+}
+
+// The caller's struct widened to this library's layout; fields the caller
+// does not have keep their defaults
+weldsim_config readConfig(const weldsim_config& caller) {
+    if (caller.struct_size < CONFIG_V1_SIZE) {
+        throw std::invalid_argument("weldsim_config.struct_size too small; initialise it with weldsim_config_default()");
+    }
+    weldsim_config c = defaultConfig();
+    std::memcpy(&c, &caller, configBytes(caller));
+    return c;
+}
+
+SimulationConfig toSimulationConfig(const weldsim_config& caller) {
+    const weldsim_config c = readConfig(caller);
+    if (c.weld_direction != WELDSIM_DIRECTION_X && c.weld_direction != WELDSIM_DIRECTION_Y) {
+        throw std::invalid_argument("Invalid weld_direction " + std::to_string(c.weld_direction));
+    }
+    if (c.weld_process < WELDSIM_PROCESS_TIG || c.weld_process > WELDSIM_PROCESS_ERW) {
+        throw std::invalid_argument("Invalid weld_process " + std::to_string(c.weld_process));
+    }
+
+    SimulationConfig s;
+    s.Lx = c.Lx;
+    s.Ly = c.Ly;
+    s.thickness = c.thickness;
+    s.nx = c.nx;
+    s.ny = c.ny;
+
+    s.mat_1_rho = c.mat_1_rho;
+    s.mat_1_cp = c.mat_1_cp;
+    s.mat_1_k = c.mat_1_k;
+    s.mat_1_T_melt = c.mat_1_T_melt;
+    s.mat_1_T_crit = c.mat_1_T_crit;
+    s.mat_2_rho = c.mat_2_rho;
+    s.mat_2_cp = c.mat_2_cp;
+    s.mat_2_k = c.mat_2_k;
+    s.mat_2_T_melt = c.mat_2_T_melt;
+    s.mat_2_T_crit = c.mat_2_T_crit;
+
+    s.V = c.V;
+    s.I = c.I;
+    s.eta = c.eta;
+    s.v_weld = c.v_weld;
+    s.x_start = c.x_start;
+    s.y_arc = c.y_arc;
+    s.weld_direction = (c.weld_direction == WELDSIM_DIRECTION_Y) ? "y" : "x";
+    s.weld_process = PROCESS_NAMES[c.weld_process];
+    s.use_gas = c.use_gas != 0;
+
+    s.a = c.a;
+    s.b = c.b;
+    s.cf = c.cf;
+    s.cr = c.cr;
+    s.ff = c.ff;
+    s.fr = c.fr;
+
+    s.T0 = c.T0;
+    s.h_conv = c.h_conv;
+    s.dt = c.dt;
+    s.t_end = (c.t_end > 0.0) ? c.t_end : -1.0;
+    s.T_t85_high = c.T_t85_high;
+    s.T_t85_low = c.T_t85_low;
+
+    if (c.output_dir) {
+        s.output_dir = c.output_dir;
+    }
+
+    s.Q_beam = c.Q_beam;
+    s.R_beam = c.R_beam;
+    s.H_beam = c.H_beam;
+    s.erw_current_density = c.erw_current_density;
+    s.erw_sigma_e = c.erw_sigma_e;
+    s.erw_contact_width = c.erw_contact_width;
+    s.erw_contact_resistance = c.erw_contact_resistance;
+    s.erw_melt_factor = c.erw_melt_factor;
+
+    // The caller owns stepping and output: no cache, checkpoints or telemetry
+    s.use_cache = false;
+    return s;
+}
+
+// Every field but struct_size and output_dir, into a full-size struct
+void fillConfig(const SimulationConfig& s, weldsim_config& c) {
+    c.Lx = s.Lx;
+    c.Ly = s.Ly;
+    c.thickness = s.thickness;
+    c.nx = s.nx;
+    c.ny = s.ny;
+
+    c.mat_1_rho = s.mat_1_rho;
+    c.mat_1_cp = s.mat_1_cp;
+    c.mat_1_k = s.mat_1_k;
+    c.mat_1_T_melt = s.mat_1_T_melt;
+    c.mat_1_T_crit = s.mat_1_T_crit;
+    c.mat_2_rho = s.mat_2_rho;
+    c.mat_2_cp = s.mat_2_cp;
+    c.mat_2_k = s.mat_2_k;
+    c.mat_2_T_melt = s.mat_2_T_melt;
+    c.mat_2_T_crit = s.mat_2_T_crit;
+
+    c.V = s.V;
+    c.I = s.I;
+    c.eta = s.eta;
+    c.v_weld = s.v_weld;
+    c.x_start = s.x_start;
+    c.y_arc = s.y_arc;
+    c.weld_direction = (s.weld_direction == "y") ? WELDSIM_DIRECTION_Y : WELDSIM_DIRECTION_X;
+    c.weld_process = WELDSIM_PROCESS_TIG;
+    for (int p = WELDSIM_PROCESS_TIG; p <= WELDSIM_PROCESS_ERW; ++p) {
+        if (s.weld_process == PROCESS_NAMES[p]) {
+            c.weld_process = p;
+        }
+    }
+    c.use_gas = s.use_gas ? 1 : 0;
+
+    c.a = s.a;
+    c.b = s.b;
+    c.cf = s.cf;
+    c.cr = s.cr;
+    c.ff = s.ff;
+    c.fr = s.fr;
+
+    c.T0 = s.T0;
+    c.h_conv = s.h_conv;
+    c.dt = s.dt;
+    c.t_end = s.t_end;
+    c.T_t85_high = s.T_t85_high;
+    c.T_t85_low = s.T_t85_low;
+
+    c.Q_beam = s.Q_beam;
+    c.R_beam = s.R_beam;
+    c.H_beam = s.H_beam;
+    c.erw_current_density = s.erw_current_density;
+    c.erw_sigma_e = s.erw_sigma_e;
+    c.erw_contact_width = s.erw_contact_width;
+    c.erw_contact_resistance = s.erw_contact_resistance;
+    c.erw_melt_factor = s.erw_melt_factor;
+}
+
+// Write s into the caller's struct, touching only its struct_size bytes
+void fromSimulationConfig(const SimulationConfig& s, weldsim_config& caller) {
+    weldsim_config c = readConfig(caller);
+    fillConfig(s, c);
+    std::memcpy(&caller, &c, configBytes(caller));
+}
+
+} // namespace
+
+extern "C" {
+
+const char* weldsim_version(void) {
+    static const std::string version = std::to_string(WELDSIM_API_VERSION) + " (solver " + SOLVER_VERSION + ")";
+    return version.c_str();
+}
+
+int weldsim_api_version(void) {
+    return WELDSIM_API_VERSION;
+}
+
+const char* weldsim_last_error(void) {
+    return last_error.c_str();
+}
+
+int weldsim_config_init(weldsim_config* config, uint32_t size) {
+    if (!config) {
+        setError("weldsim_config_init: null config");
+        return -1;
+    }
+    if (size < CONFIG_V1_SIZE) {
+        setError("weldsim_config_init: size " + std::to_string(size) + " is smaller than weldsim_config version 1");
+        return -1;
+    }
+    weldsim_config c = defaultConfig();
+    c.struct_size = size;
+    const size_t bytes = configBytes(c);
+    std::memcpy(config, &c, bytes);
+    std::memset(reinterpret_cast<char*>(config) + bytes, 0, size - bytes);  // Fields newer than this library
+    return 0;
+}
+
+// Binaries built before weldsim_config_init() call this symbol with a
+// version 1 struct; weldsim.h now makes the name a macro
+#undef weldsim_config_default
+void weldsim_config_default(weldsim_config* config);
+void weldsim_config_default(weldsim_config* config) {
+    weldsim_config_init(config, static_cast<uint32_t>(CONFIG_V1_SIZE));
+}
+
+int weldsim_config_load(weldsim_config* config, const char* filename) {
+    if (!config || !filename) {
+        setError("weldsim_config_load: null argument");
+        return -1;
+    }
+    try {
+        SimulationConfig s = toSimulationConfig(*config);
+        loadConfigFile(filename, s);
+        fromSimulationConfig(s, *config);
+        return 0;
+    } catch (const std::exception& e) {
+        setError(e.what());
+        return -1;
+    }
+}
+
+weldsim* weldsim_create(const weldsim_config* config) {
+    if (!config) {
+        setError("weldsim_create: null config");
+        return nullptr;
+    }
+    try {
+        std::unique_ptr<weldsim> sim(new weldsim);
+        sim->simulation.reset(new WeldingSimulation(toSimulationConfig(*config), nullptr, nullptr));
+        return sim.release();
+    } catch (const std::exception& e) {
+        setError(e.what());
+        return nullptr;
+    }
+}
+
+void weldsim_destroy(weldsim* sim) {
+    if (!sim) {
+        return;
+    }
+    try {
+        sim->simulation->finish();
+    } catch (...) {
+        // Destruction never fails; finish() only flushes
+    }
+    delete sim;
+}
+
+int32_t weldsim_step(weldsim* sim, int32_t n) {
+    if (!sim) {
+        setError("weldsim_step: null simulation");
+        return -1;
+    }
+    try {
+        WeldingSimulation& s = *sim->simulation;
+        const int steps = s.advance(n);
+        if (s.currentStep() == s.totalSteps()) {
+            s.finish();
+        }
+        return steps;
+    } catch (const std::exception& e) {
+        setError(e.what());
+        return -1;
+    }
+}
+
+int32_t weldsim_current_step(const weldsim* sim) {
+    return sim ? sim->simulation->currentStep() : 0;
+}
+
+int32_t weldsim_total_steps(const weldsim* sim) {
+    return sim ? sim->simulation->totalSteps() : 0;
+}
+
+double weldsim_time(const weldsim* sim) {
+    return sim ? sim->simulation->currentTime() : 0.0;
+}
+
+void weldsim_grid(const weldsim* sim, int32_t* nx, int32_t* ny, const double** x, const double** y) {
+    if (!sim) {
+        return;
+    }
+    const SimulationConfig& config = sim->simulation->config();
+    const SimulationGrid& grid = sim->simulation->grid();
+    if (nx) *nx = config.nx;
+    if (ny) *ny = config.ny;
+    if (x) *x = grid.x.data();
+    if (y) *y = grid.y.data();
+}
+
+const double* weldsim_temperature(const weldsim* sim) {
+    return sim ? sim->simulation->temperature().data() : nullptr;
+}
+
+const double* weldsim_peak_temperature(const weldsim* sim) {
+    return sim ? sim->simulation->peakTemperature().data() : nullptr;
+}
+
+int32_t weldsim_history_rows(const weldsim* sim) {
+    return sim ? sim->simulation->history().size() : 0;
+}
+
+int32_t weldsim_history_series_count(const weldsim* sim) {
+    return sim ? sim->simulation->history().seriesCount() : 0;
+}
+
+const char* weldsim_history_series_name(const weldsim* sim, int32_t k) {
+    if (!sim || k < 0 || k >= sim->simulation->history().seriesCount()) {
+        return nullptr;
+    }
+    return sim->simulation->history().name(k).c_str();
+}
+
+const double* weldsim_history_time(const weldsim* sim) {
+    return sim ? sim->simulation->history().times() : nullptr;
+}
+
+const double* weldsim_history_series(const weldsim* sim, int32_t k) {
+    if (!sim || k < 0 || k >= sim->simulation->history().seriesCount()) {
+        return nullptr;
+    }
+    return sim->simulation->history().series(k);
+}
+
+int weldsim_statistics_get(const weldsim* sim, weldsim_statistics* stats) {
+    if (!sim || !stats) {
+        setError("weldsim_statistics_get: null argument");
+        return -1;
+    }
+    try {
+        const SimulationStatistics s = sim->simulation->statistics();
+        stats->T_peak = s.T_peak;
+        stats->fusion_area = s.fusion_area;
+        stats->HAZ_area = s.HAZ_area;
+        stats->peak_cooling_rate = s.peak_cooling_rate;
+        stats->t85_min = s.t85_min;
+        stats->t85_max = s.t85_max;
+        return 0;
+    } catch (const std::exception& e) {
+        setError(e.what());
+        return -1;
+    }
+}
+
+int weldsim_export(weldsim* sim) {
+    if (!sim) {
+        setError("weldsim_export: null simulation");
+        return -1;
+    }
+    try {
+        std::filesystem::create_directories(sim->simulation->config().output_dir);
+        sim->simulation->exportResults();
+        return 0;
+    } catch (const std::exception& e) {
+        setError(e.what());
+        return -1;
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,159 @@
+#ifndef WELDSIM_H
+#define WELDSIM_H
+
+/*
+ * C interface of libweldsim (libweldsim.so / libweldsim.a).
+ *
+ * A simulation is created from a plain configuration struct, advanced a
+ * number of steps at a time, and its fields are read in place through
+ * pointers into the solver's own buffers: no copies are made. All functions
+ * are safe to call from C; C++ exceptions never cross this interface.
+ * Errors are reported by return value (NULL or -1), with a description from
+ * weldsim_last_error() on the calling thread.
+ *
+ * ABI stability: weldsim is opaque, and weldsim_config starts with its own
+ * size, so fields can be appended in later versions without breaking
+ * callers built against this header. The library reads and writes only the
+ * first struct_size bytes of a caller's struct. Always initialise it with
+ * weldsim_config_default(), which passes the size the caller was compiled
+ * with.
+ *
+ * Link against libweldsim, which needs OpenMP and pthreads (e.g. with
+ * -fopenmp -pthread).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WELDSIM_API_VERSION 2
+
+typedef struct weldsim weldsim;
+
+enum {
+    WELDSIM_DIRECTION_X = 0,         /* Travel along x across the interface */
+    WELDSIM_DIRECTION_Y = 1          /* Travel along y on the interface */
+};
+
+enum {
+    WELDSIM_PROCESS_TIG = 0,
+    WELDSIM_PROCESS_ELECTRODE = 1,
+    WELDSIM_PROCESS_CUSTOM = 2,      /* Uses eta */
+    WELDSIM_PROCESS_EBW = 3,         /* Electron beam; this and the following use eta */
+    WELDSIM_PROCESS_LBW = 4,         /* Laser beam */
+    WELDSIM_PROCESS_PAW = 5,         /* Plasma arc */
+    WELDSIM_PROCESS_SAW = 6,         /* Submerged arc */
+    WELDSIM_PROCESS_ERW = 7          /* Electric resistance */
+};
+
+/* Physical and numerical parameters (SI units, temperatures in K) */
+typedef struct weldsim_config {
+    uint32_t struct_size;            /* Caller's sizeof(weldsim_config), set by weldsim_config_init() */
+
+    /* Domain and mesh */
+    double Lx, Ly, thickness;
+    int32_t nx, ny;
+
+    /* Material 1 (x < Lx/2) and material 2 */
+    double mat_1_rho, mat_1_cp, mat_1_k, mat_1_T_melt, mat_1_T_crit;
+    double mat_2_rho, mat_2_cp, mat_2_k, mat_2_T_melt, mat_2_T_crit;
+
+    /* Heat source */
+    double V, I, eta, v_weld, x_start, y_arc;
+    int32_t weld_direction;          /* WELDSIM_DIRECTION_* */
+    int32_t weld_process;            /* WELDSIM_PROCESS_* */
+    int32_t use_gas;
+
+    /* Goldak double ellipsoid */
+    double a, b, cf, cr, ff, fr;
+
+    /* Time stepping and cooling thresholds */
+    double T0, h_conv, dt;
+    double t_end;                    /* <= 0: until the arc leaves the plate plus 10 s */
+    double T_t85_high, T_t85_low;
+
+    /* Output directory for weldsim_export() (NULL = "output"); copied by weldsim_create() */
+    const char* output_dir;
+
+    /* Beam and resistance sources (API version 2) */
+    double Q_beam, R_beam, H_beam;
+    double erw_current_density, erw_sigma_e, erw_contact_width;
+    double erw_contact_resistance, erw_melt_factor;
+} weldsim_config;
+
+/* Peak temperature, zone areas and cooling metrics of the current state */
+typedef struct weldsim_statistics {
+    double T_peak;                   /* K */
+    double fusion_area;              /* m^2 */
+    double HAZ_area;                 /* m^2 */
+    double peak_cooling_rate;        /* K/s */
+    double t85_min;                  /* s, -1 if no cell cooled through both thresholds */
+    double t85_max;                  /* s */
+} weldsim_statistics;
+
+/* Library version string and WELDSIM_API_VERSION of the built library */
+const char* weldsim_version(void);
+int weldsim_api_version(void);
+
+/* Description of the last failed call on this thread ("" if none) */
+const char* weldsim_last_error(void);
+
+/* Fill the first `size` bytes of config with the defaults of the welding_sim
+ * executable and set struct_size = size. size is the caller's
+ * sizeof(weldsim_config); fields the library does not know are zeroed.
+ * 0, or -1 if size is smaller than an API version 1 struct. */
+int weldsim_config_init(weldsim_config* config, uint32_t size);
+
+/* weldsim_config_init() with the size of this header's struct */
+#define weldsim_config_default(config) weldsim_config_init((config), (uint32_t)sizeof(weldsim_config))
+
+/* Load a config.json file (same schema as --config) over the values in config;
+ * output_dir is left as it is. 0 or -1. */
+int weldsim_config_load(weldsim_config* config, const char* filename);
+
+/* Create a simulation at t = 0; NULL on invalid configuration */
+weldsim* weldsim_create(const weldsim_config* config);
+
+void weldsim_destroy(weldsim* sim);
+
+/* Advance up to n time steps. Returns the steps run (0 once the end time is
+ * reached) or -1 on error. */
+int32_t weldsim_step(weldsim* sim, int32_t n);
+
+int32_t weldsim_current_step(const weldsim* sim);
+int32_t weldsim_total_steps(const weldsim* sim);
+double weldsim_time(const weldsim* sim);
+
+/* Grid size and cell coordinates (x has nx entries, y has ny) */
+void weldsim_grid(const weldsim* sim, int32_t* nx, int32_t* ny, const double** x, const double** y);
+
+/* Current temperature field, row-major ny x nx (x fastest), in place. The
+ * solver swaps buffers every step, so the pointer is valid until the next
+ * weldsim_step() or weldsim_destroy(); fetch it again after stepping. */
+const double* weldsim_temperature(const weldsim* sim);
+
+/* Peak temperature reached at every cell so far, row-major ny x nx. This
+ * buffer is fixed for the lifetime of the simulation and updated in place. */
+const double* weldsim_peak_temperature(const weldsim* sim);
+
+/* Monitoring probe history held in memory: `rows` samples of the time
+ * column and of each series (weldsim_history_series). Valid until the next
+ * weldsim_step() or weldsim_destroy(). */
+int32_t weldsim_history_rows(const weldsim* sim);
+int32_t weldsim_history_series_count(const weldsim* sim);
+const char* weldsim_history_series_name(const weldsim* sim, int32_t k);
+const double* weldsim_history_time(const weldsim* sim);
+const double* weldsim_history_series(const weldsim* sim, int32_t k);
+
+int weldsim_statistics_get(const weldsim* sim, weldsim_statistics* stats);
+
+/* Write the result files of the current state to config.output_dir; 0 or -1 */
+int weldsim_export(weldsim* sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WELDSIM_H */
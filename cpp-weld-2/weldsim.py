@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""
+Python bindings for the C++ welding solver (libweldsim).
+
+The fields are NumPy arrays backed by the solver's own buffers: reading
+them copies nothing, whatever the grid size. step() runs in C++ without
+holding the GIL, so other Python threads keep running meanwhile.
+
+    import weldsim
+
+    sim = weldsim.Simulation(nx=301, ny=201, weld_process="TIG")
+    while sim.step(100):
+        T = sim.T                     # (ny, nx) view of the current field
+        print(sim.time, T.max())
+    T_max = sim.T_max
+    history = sim.history()           # {"time": ..., "pt1": ..., ...}
+
+The solver is freed when the Simulation and every array taken from it are
+gone, so a view can never outlive its buffer.
+
+Build the library first (cmake, or `make lib`). It is looked up in
+$WELDSIM_LIBRARY, next to this file, in ./build and on the system path.
+"""
+
+import ctypes
+import ctypes.util
+import os
+
+import numpy as np
+
+API_VERSION = 2
+
+DIRECTIONS = {"x": 0, "y": 1}
+PROCESSES = {"TIG": 0, "Electrode": 1, "Custom": 2, "EBW": 3, "LBW": 4, "PAW": 5, "SAW": 6, "ERW": 7}
+
+
+class _Config(ctypes.Structure):
+    # Mirrors weldsim_config in weldsim.h
+    _fields_ = [("struct_size", ctypes.c_uint32)] + \
+        [(name, ctypes.c_double) for name in ("Lx", "Ly", "thickness")] + \
+        [(name, ctypes.c_int32) for name in ("nx", "ny")] + \
+        [(name, ctypes.c_double) for name in (
+            "mat_1_rho", "mat_1_cp", "mat_1_k", "mat_1_T_melt", "mat_1_T_crit",
+            "mat_2_rho", "mat_2_cp", "mat_2_k", "mat_2_T_melt", "mat_2_T_crit",
+            "V", "I", "eta", "v_weld", "x_start", "y_arc")] + \
+        [(name, ctypes.c_int32) for name in ("weld_direction", "weld_process", "use_gas")] + \
+        [(name, ctypes.c_double) for name in (
+            "a", "b", "cf", "cr", "ff", "fr",
+            "T0", "h_conv", "dt", "t_end", "T_t85_high", "T_t85_low")] + \
+        [("output_dir", ctypes.c_char_p)] + \
+        [(name, ctypes.c_double) for name in (
+            "Q_beam", "R_beam", "H_beam", "erw_current_density", "erw_sigma_e",
+            "erw_contact_width", "erw_contact_resistance", "erw_melt_factor")]
+
+
+class _Statistics(ctypes.Structure):
+    _fields_ = [(name, ctypes.c_double) for name in (
+        "T_peak", "fusion_area", "HAZ_area", "peak_cooling_rate", "t85_min", "t85_max")]
+
+
+_DOUBLE_P = ctypes.POINTER(ctypes.c_double)
+_lib = None
+
+
+def _library_candidates():
+    if os.environ.get("WELDSIM_LIBRARY"):
+        yield os.environ["WELDSIM_LIBRARY"]
+    here = os.path.dirname(os.path.abspath(__file__))
+    for directory in (here, os.path.join(here, "build"), os.path.join(os.getcwd(), "build")):
+        yield os.path.join(directory, "libweldsim.so")
+    found = ctypes.util.find_library("weldsim")
+    if found:
+        yield found
+
+
+def _load():
+    global _lib
+    if _lib is not None:
+        return _lib
+
+    errors = []
+    for path in _library_candidates():
+        if os.path.sep in path and not os.path.exists(path):
+            continue
+        try:
+            lib = ctypes.CDLL(path)
+            break
+        except OSError as e:
+            errors.append(str(e))
+    else:
+        raise OSError("libweldsim.so not found; build it (cmake or `make lib`) or set "
+                      "WELDSIM_LIBRARY" + ("".join("\n  " + e for e in errors)))
+
+    sim_p = ctypes.c_void_p
+    signatures = {
+        "weldsim_api_version": (ctypes.c_int, []),
+        "weldsim_version": (ctypes.c_char_p, []),
+        "weldsim_last_error": (ctypes.c_char_p, []),
+        "weldsim_config_init": (ctypes.c_int, [ctypes.POINTER(_Config), ctypes.c_uint32]),
+        "weldsim_config_load": (ctypes.c_int, [ctypes.POINTER(_Config), ctypes.c_char_p]),
+        "weldsim_create": (sim_p, [ctypes.POINTER(_Config)]),
+        "weldsim_destroy": (None, [sim_p]),
+        "weldsim_step": (ctypes.c_int32, [sim_p, ctypes.c_int32]),
+        "weldsim_current_step": (ctypes.c_int32, [sim_p]),
+        "weldsim_total_steps": (ctypes.c_int32, [sim_p]),
+        "weldsim_time": (ctypes.c_double, [sim_p]),
+        "weldsim_grid": (None, [sim_p, ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32),
+                                ctypes.POINTER(_DOUBLE_P), ctypes.POINTER(_DOUBLE_P)]),
+        "weldsim_temperature": (_DOUBLE_P, [sim_p]),
+        "weldsim_peak_temperature": (_DOUBLE_P, [sim_p]),
+        "weldsim_history_rows": (ctypes.c_int32, [sim_p]),
+        "weldsim_history_series_count": (ctypes.c_int32, [sim_p]),
+        "weldsim_history_series_name": (ctypes.c_char_p, [sim_p, ctypes.c_int32]),
+        "weldsim_history_time": (_DOUBLE_P, [sim_p]),
+        "weldsim_history_series": (_DOUBLE_P, [sim_p, ctypes.c_int32]),
+        "weldsim_statistics_get": (ctypes.c_int, [sim_p, ctypes.POINTER(_Statistics)]),
+        "weldsim_export": (ctypes.c_int, [sim_p]),
+    }
+    for name, (restype, argtypes) in signatures.items():
+        function = getattr(lib, name)
+        function.restype = restype
+        function.argtypes = argtypes
+
+    if lib.weldsim_api_version() != API_VERSION:
+        raise OSError(f"libweldsim API version {lib.weldsim_api_version()}, expected {API_VERSION}")
+    _lib = lib
+    return lib
+
+
+def _error():
+    return RuntimeError(_load().weldsim_last_error().decode())
+
+
+class _View:
+    """Array interface over a solver buffer; keeps the simulation alive."""
+
+    def __init__(self, owner, pointer, shape):
+        self.owner = owner
+        self.__array_interface__ = {
+            "version": 3,
+            "shape": shape,
+            "typestr": "<f8",
+            "data": (ctypes.cast(pointer, ctypes.c_void_p).value, True),   # read-only
+        }
+
+
+class Config:
+    """Simulation parameters (weldsim_config), defaults as in welding_sim."""
+
+    def __init__(self, filename=None, **params):
+        self._config = _Config()
+        self._output_dir = None
+        _load().weldsim_config_init(ctypes.byref(self._config), ctypes.sizeof(_Config))
+        if filename is not None:
+            self.load(filename)
+        for name, value in params.items():
+            setattr(self, name, value)
+
+    def load(self, filename):
+        """Apply a config.json file (same schema as welding_sim --config)."""
+        if _load().weldsim_config_load(ctypes.byref(self._config), os.fsencode(filename)) != 0:
+            raise _error()
+
+    def __setattr__(self, name, value):
+        if name.startswith("_"):
+            object.__setattr__(self, name, value)
+        elif name == "weld_direction":
+            self._config.weld_direction = DIRECTIONS[value]
+        elif name == "weld_process":
+            self._config.weld_process = PROCESSES[value]
+        elif name == "output_dir":
+            self._output_dir = os.fsencode(value)   # Kept alive for the struct
+            self._config.output_dir = self._output_dir
+        elif name in dict(_Config._fields_) and name != "struct_size":
+            setattr(self._config, name, value)
+        else:
+            raise AttributeError(f"unknown parameter '{name}'")
+
+    def __getattr__(self, name):
+        config = self.__dict__["_config"]
+        if name == "weld_direction":
+            return {v: k for k, v in DIRECTIONS.items()}[config.weld_direction]
+        if name == "weld_process":
+            return {v: k for k, v in PROCESSES.items()}[config.weld_process]
+        if name == "output_dir":
+            return os.fsdecode(config.output_dir) if config.output_dir else "output"
+        if name in dict(_Config._fields_):
+            return getattr(config, name)
+        raise AttributeError(name)
+
+
+class Simulation:
+    """A WeldingSimulation stepped from Python, with zero-copy field access."""
+
+    def __init__(self, config=None, **params):
+        if config is None:
+            config = Config(**params)
+        elif params:
+            raise TypeError("pass either a Config or keyword parameters")
+        lib = _load()
+        self._lib = lib
+        self.config = config
+        self._handle = lib.weldsim_create(ctypes.byref(config._config))
+        if not self._handle:
+            raise _error()
+
+        nx, ny = ctypes.c_int32(), ctypes.c_int32()
+        x, y = _DOUBLE_P(), _DOUBLE_P()
+        lib.weldsim_grid(self._handle, ctypes.byref(nx), ctypes.byref(ny), ctypes.byref(x), ctypes.byref(y))
+        self.nx, self.ny = nx.value, ny.value
+        self.x = np.asarray(_View(self, x, (self.nx,)))
+        self.y = np.asarray(_View(self, y, (self.ny,)))
+
+    def __del__(self):
+        if getattr(self, "_handle", None):
+            self._lib.weldsim_destroy(self._handle)
+            self._handle = None
+
+    def step(self, n=1):
+        """Advance up to n steps (GIL released); returns the number run, 0 at the end."""
+        steps = self._lib.weldsim_step(self._handle, n)
+        if steps < 0:
+            raise _error()
+        return steps
+
+    def run(self):
+        """Advance to the end time."""
+        while self.step(max(1, self.total_steps - self.current_step)):
+            pass
+
+    @property
+    def current_step(self):
+        return self._lib.weldsim_current_step(self._handle)
+
+    @property
+    def total_steps(self):
+        return self._lib.weldsim_total_steps(self._handle)
+
+    @property
+    def time(self):
+        return self._lib.weldsim_time(self._handle)
+
+    @property
+    def T(self):
+        """Current temperature field (K), read-only (ny, nx) view.
+
+        The solver swaps two buffers every step, so a view taken before
+        step() then shows stale data: read sim.T again after stepping
+        (or copy it to keep it)."""
+        return np.asarray(_View(self, self._lib.weldsim_temperature(self._handle), (self.ny, self.nx)))
+
+    @property
+    def T_max(self):
+        """Peak temperature reached at every cell (K), (ny, nx) view updated in place."""
+        return np.asarray(_View(self, self._lib.weldsim_peak_temperature(self._handle), (self.ny, self.nx)))
+
+    def history(self):
+        """Monitoring probe history: {"time": ..., "<probe>": ...} views, one row per step."""
+        lib, handle = self._lib, self._handle
+        rows = lib.weldsim_history_rows(handle)
+        result = {"time": np.asarray(_View(self, lib.weldsim_history_time(handle), (rows,)))}
+        for k in range(lib.weldsim_history_series_count(handle)):
+            name = lib.weldsim_history_series_name(handle, k).decode()
+            result[name] = np.asarray(_View(self, lib.weldsim_history_series(handle, k), (rows,)))
+        return result
+
+    def statistics(self):
+        """Peak temperature, zone areas (m²), peak cooling rate and t8/5 range."""
+        stats = _Statistics()
+        if self._lib.weldsim_statistics_get(self._handle, ctypes.byref(stats)) != 0:
+            raise _error()
+        return {name: getattr(stats, name) for name, _ in _Statistics._fields_}
+
+    def export(self):
+        """Write the CSV result files of the current state to config.output_dir."""
+        if self._lib.weldsim_export(self._handle) != 0:
+            raise _error()
+
+
+def version():
+    return _load().weldsim_version().decode()